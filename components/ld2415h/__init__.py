@@ -1,7 +1,17 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import uart
-from esphome.const import CONF_ID
+from esphome import automation, pins
+from esphome.components import time, uart
+from esphome.const import (
+    CONF_DIRECTION,
+    CONF_SENSITIVITY,
+    CONF_ID,
+    CONF_PIN,
+    CONF_PRIORITY,
+    CONF_SPEED,
+    CONF_TIME_ID,
+    CONF_TRIGGER_ID,
+)
 
 CODEOWNERS = ["@cptskippy"]
 
@@ -11,13 +21,210 @@ MULTI_CONF = True
 
 ld2415h_ns = cg.esphome_ns.namespace("ld2415h")
 LD2415HComponent = ld2415h_ns.class_("LD2415HComponent", cg.Component, uart.UARTDevice)
+SampleRateStructure = ld2415h_ns.enum("SampleRateStructure")
+Direction = ld2415h_ns.enum("Direction")
+VehicleEvent = ld2415h_ns.struct("VehicleEvent")
+VehicleTrigger = ld2415h_ns.class_(
+    "VehicleTrigger", automation.Trigger.template(VehicleEvent)
+)
+ConfigureAction = ld2415h_ns.class_("ConfigureAction", automation.Action)
+Calibration = ld2415h_ns.class_("Calibration", cg.Component)
+CalibrationStartAction = ld2415h_ns.class_("CalibrationStartAction", automation.Action)
+CalibrationCancelAction = ld2415h_ns.class_(
+    "CalibrationCancelAction", automation.Action
+)
+CalibrationApplyAction = ld2415h_ns.class_("CalibrationApplyAction", automation.Action)
+TrafficLog = ld2415h_ns.class_("TrafficLog", cg.Component)
+TrafficLogReplayTrigger = ld2415h_ns.class_(
+    "TrafficLogReplayTrigger", automation.Trigger.template(VehicleEvent, cg.uint32)
+)
+TrafficLogDumpAction = ld2415h_ns.class_("TrafficLogDumpAction", automation.Action)
+TrafficLogReplayAction = ld2415h_ns.class_("TrafficLogReplayAction", automation.Action)
+TrafficLogClearAction = ld2415h_ns.class_("TrafficLogClearAction", automation.Action)
 
 CONF_LD2415H_ID = "ld2415h_id"
+CONF_DOUBLE_LISTENER = "double_listener"
+CONF_BATCH_SIZE = "batch_size"
+CONF_BATCH_INTERVAL = "batch_interval"
+CONF_DIAGNOSTICS_INTERVAL = "diagnostics_interval"
+CONF_FRAME_LOGGING = "frame_logging"
+CONF_FRAME_SUMMARY_INTERVAL = "frame_summary_interval"
+CONF_PROFILING = "profiling"
+CONF_READER_TASK = "reader_task"
+CONF_CORE = "core"
+CONF_EVENT_GAP = "event_gap"
+CONF_MAX_TRACKS = "max_tracks"
+CONF_TRACK_GATE = "track_gate"
+CONF_ON_VEHICLE = "on_vehicle"
+CONF_CONFIG_CACHE = "config_cache"
+CONF_SAMPLE_RATE_GOVERNOR = "sample_rate_governor"
+CONF_ACTIVE_RATE = "active_rate"
+CONF_IDLE_RATE = "idle_rate"
+CONF_HOLD_TIME = "hold_time"
+CONF_ACTIVATION_FRAMES = "activation_frames"
+CONF_SPEED_TRIGGER = "speed_trigger"
+CONF_HYSTERESIS = "hysteresis"
+CONF_CONFIG_DEBOUNCE = "config_debounce"
+CONF_MIN_SPEED_THRESHOLD = "min_speed_threshold"
+CONF_COMPENSATION_ANGLE = "compensation_angle"
+CONF_TRACKING_MODE = "tracking_mode"
+CONF_SAMPLE_RATE = "sample_rate"
+CONF_VIBRATION_CORRECTION = "vibration_correction"
+CONF_RELAY_TRIGGER_DURATION = "relay_trigger_duration"
+CONF_RELAY_TRIGGER_SPEED = "relay_trigger_speed"
+CONF_CALIBRATION = "calibration"
+CONF_SETTLE_TIME = "settle_time"
+CONF_DWELL_TIME = "dwell_time"
+CONF_SENSITIVITY_STEP = "sensitivity_step"
+CONF_VIBRATION_CORRECTION_STEP = "vibration_correction_step"
+CONF_MAX_FALSE_RATE = "max_false_rate"
+CONF_NOISE_SPEED = "noise_speed"
+CONF_NOISE_JITTER = "noise_jitter"
+CONF_MIN_FRAMES = "min_frames"
+CONF_TRAFFIC_LOG = "traffic_log"
+CONF_PAGES = "pages"
+CONF_FLUSH_INTERVAL = "flush_interval"
+CONF_ON_REPLAY = "on_replay"
+
+TRIGGER_DIRECTIONS = {
+    "any": Direction.DIRECTION_NONE,
+    "approaching": Direction.DIRECTION_APPROACHING,
+    "retreating": Direction.DIRECTION_RETREATING,
+}
+
+# Display names in enum value order, matching the EnumTable definitions in ld2415h.h
+SAMPLE_RATE_OPTIONS = ["~22 fps", "~11 fps", "~6 fps"]
+TRACKING_MODE_OPTIONS = ["Approaching and Retreating", "Approaching", "Retreating"]
+
+SAMPLE_RATES = dict(
+    zip(
+        SAMPLE_RATE_OPTIONS,
+        [
+            SampleRateStructure.SAMPLE_RATE_22FPS,
+            SampleRateStructure.SAMPLE_RATE_11FPS,
+            SampleRateStructure.SAMPLE_RATE_6FPS,
+        ],
+    )
+)
+
+TRACKING_MODES = dict(zip(TRACKING_MODE_OPTIONS, range(len(TRACKING_MODE_OPTIONS))))
+
+READER_TASK_SCHEMA = cv.All(
+    cv.only_on_esp32,
+    cv.Schema(
+        {
+            cv.Optional(CONF_CORE, default=1): cv.int_range(min=0, max=1),
+            cv.Optional(CONF_PRIORITY, default=5): cv.int_range(min=1, max=24),
+        }
+    ),
+)
+
+SAMPLE_RATE_GOVERNOR_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_ACTIVE_RATE, default="~22 fps"): cv.enum(SAMPLE_RATES),
+        cv.Optional(CONF_IDLE_RATE, default="~6 fps"): cv.enum(SAMPLE_RATES),
+        cv.Optional(
+            CONF_HOLD_TIME, default="5s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_ACTIVATION_FRAMES, default=2): cv.int_range(min=1, max=255),
+    }
+)
+
+SPEED_TRIGGER_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_PIN): pins.internal_gpio_output_pin_schema,
+        cv.Required(CONF_SPEED): cv.float_range(min=0.1, max=999.9),
+        cv.Optional(CONF_HYSTERESIS, default=0): cv.float_range(min=0, max=999.9),
+        cv.Optional(CONF_DIRECTION, default="approaching"): cv.enum(
+            TRIGGER_DIRECTIONS, lower=True
+        ),
+        cv.Optional(
+            CONF_HOLD_TIME, default="500ms"
+        ): cv.positive_time_period_milliseconds,
+    }
+)
+
+CALIBRATION_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(Calibration),
+        cv.Optional(
+            CONF_SETTLE_TIME, default="5s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_DWELL_TIME, default="30s"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(seconds=1)),
+        ),
+        cv.Optional(CONF_SENSITIVITY_STEP, default=2): cv.int_range(min=1, max=14),
+        cv.Optional(CONF_VIBRATION_CORRECTION_STEP, default=16): cv.int_range(
+            min=1, max=112
+        ),
+        cv.Optional(CONF_MAX_FALSE_RATE, default=1.0): cv.positive_float,
+        cv.Optional(CONF_NOISE_SPEED, default=5.0): cv.float_range(min=0, max=999),
+        cv.Optional(CONF_NOISE_JITTER, default=5.0): cv.float_range(min=0, max=999),
+        cv.Optional(CONF_MIN_FRAMES, default=3): cv.int_range(min=1, max=65535),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+# ESP8266 keeps about 512 bytes of preferences in flash, less than two pages
+TRAFFIC_LOG_SCHEMA = cv.All(
+    cv.only_on_esp32,
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(TrafficLog),
+            cv.Optional(CONF_PAGES, default=8): cv.int_range(min=2, max=64),
+            cv.Optional(
+                CONF_FLUSH_INTERVAL, default="60s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
+            cv.Optional(CONF_ON_REPLAY): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
+                        TrafficLogReplayTrigger
+                    ),
+                }
+            ),
+        }
+    ).extend(cv.COMPONENT_SCHEMA),
+)
 
 CONFIG_SCHEMA = cv.All(
     cv.Schema(
         {
             cv.GenerateID(): cv.declare_id(LD2415HComponent),
+            cv.Optional(CONF_DOUBLE_LISTENER, default=False): cv.boolean,
+            cv.Optional(CONF_BATCH_SIZE, default=32): cv.int_range(min=1, max=1024),
+            cv.Optional(
+                CONF_BATCH_INTERVAL, default="0ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_DIAGNOSTICS_INTERVAL, default="60s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_FRAME_LOGGING, default=False): cv.boolean,
+            cv.Optional(CONF_FRAME_SUMMARY_INTERVAL, default=0): cv.int_range(
+                min=0, max=65535
+            ),
+            cv.Optional(CONF_PROFILING, default=False): cv.boolean,
+            cv.Optional(CONF_READER_TASK): READER_TASK_SCHEMA,
+            cv.Optional(
+                CONF_EVENT_GAP, default="500ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_MAX_TRACKS, default=1): cv.int_range(min=1, max=4),
+            cv.Optional(CONF_TRACK_GATE, default=5.0): cv.float_range(
+                min=0.1, max=999.9
+            ),
+            cv.Optional(CONF_CONFIG_CACHE, default=True): cv.boolean,
+            cv.Optional(
+                CONF_CONFIG_DEBOUNCE, default="0ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_SAMPLE_RATE_GOVERNOR): SAMPLE_RATE_GOVERNOR_SCHEMA,
+            cv.Optional(CONF_SPEED_TRIGGER): SPEED_TRIGGER_SCHEMA,
+            cv.Optional(CONF_CALIBRATION): CALIBRATION_SCHEMA,
+            cv.Optional(CONF_TRAFFIC_LOG): TRAFFIC_LOG_SCHEMA,
+            cv.Optional(CONF_ON_VEHICLE): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(VehicleTrigger),
+                }
+            ),
         }
     )
     .extend(uart.UART_DEVICE_SCHEMA)
@@ -37,3 +244,179 @@ async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
     await uart.register_uart_device(var, config)
+
+    cg.add(var.set_batch_size(config[CONF_BATCH_SIZE]))
+    cg.add(var.set_batch_interval(config[CONF_BATCH_INTERVAL]))
+    cg.add(var.set_diagnostics_interval(config[CONF_DIAGNOSTICS_INTERVAL]))
+    cg.add(var.set_event_gap(config[CONF_EVENT_GAP]))
+    cg.add(var.set_max_tracks(config[CONF_MAX_TRACKS]))
+    cg.add(var.set_track_gate(round(config[CONF_TRACK_GATE] * 10)))
+    cg.add(var.set_frame_summary_interval(config[CONF_FRAME_SUMMARY_INTERVAL]))
+    cg.add(var.set_config_debounce(config[CONF_CONFIG_DEBOUNCE]))
+
+    if config[CONF_CONFIG_CACHE]:
+        cg.add(var.set_config_cache(str(config[CONF_ID])))
+
+    if reader_task := config.get(CONF_READER_TASK):
+        cg.add(var.set_reader_task(reader_task[CONF_CORE], reader_task[CONF_PRIORITY]))
+
+    if governor := config.get(CONF_SAMPLE_RATE_GOVERNOR):
+        cg.add(
+            var.set_sample_rate_governor(
+                governor[CONF_ACTIVE_RATE],
+                governor[CONF_IDLE_RATE],
+                governor[CONF_HOLD_TIME],
+                governor[CONF_ACTIVATION_FRAMES],
+            )
+        )
+
+    if speed_trigger := config.get(CONF_SPEED_TRIGGER):
+        pin = await cg.gpio_pin_expression(speed_trigger[CONF_PIN])
+        # Speeds are passed in tenths, the resolution of the sensor output
+        cg.add(
+            var.set_speed_trigger(
+                pin,
+                round(speed_trigger[CONF_SPEED] * 10),
+                round(speed_trigger[CONF_HYSTERESIS] * 10),
+                speed_trigger[CONF_DIRECTION],
+                speed_trigger[CONF_HOLD_TIME],
+            )
+        )
+
+    if config[CONF_DOUBLE_LISTENER]:
+        cg.add_define("USE_LD2415H_DOUBLE_LISTENER")
+
+    if config[CONF_FRAME_LOGGING]:
+        cg.add_define("USE_LD2415H_FRAME_LOGGING")
+
+    if config[CONF_PROFILING]:
+        cg.add_define("USE_LD2415H_PROFILING")
+
+    for conf in config.get(CONF_ON_VEHICLE, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [(VehicleEvent, "event")], conf)
+
+    if calibration := config.get(CONF_CALIBRATION):
+        await calibration_to_code(var, calibration)
+
+    if traffic_log := config.get(CONF_TRAFFIC_LOG):
+        await traffic_log_to_code(var, traffic_log)
+
+
+async def calibration_to_code(ld2415h, config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add(var.set_parent(ld2415h))
+    cg.add(var.set_id(str(config[CONF_ID])))
+    cg.add(var.set_settle_time(config[CONF_SETTLE_TIME]))
+    cg.add(var.set_dwell_time(config[CONF_DWELL_TIME]))
+    cg.add(var.set_sensitivity_step(config[CONF_SENSITIVITY_STEP]))
+    cg.add(var.set_vibration_correction_step(config[CONF_VIBRATION_CORRECTION_STEP]))
+    cg.add(var.set_max_false_rate(config[CONF_MAX_FALSE_RATE]))
+    # Speeds are passed in tenths, the resolution of the sensor output
+    cg.add(var.set_noise_speed(round(config[CONF_NOISE_SPEED] * 10)))
+    cg.add(var.set_noise_jitter(round(config[CONF_NOISE_JITTER] * 10)))
+    cg.add(var.set_min_frames(config[CONF_MIN_FRAMES]))
+    cg.add(ld2415h.register_listener(var))
+
+
+async def traffic_log_to_code(ld2415h, config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add(var.set_id(str(config[CONF_ID])))
+    cg.add(var.set_pages(config[CONF_PAGES]))
+    cg.add(var.set_flush_interval(config[CONF_FLUSH_INTERVAL]))
+
+    if CONF_TIME_ID in config:
+        clock = await cg.get_variable(config[CONF_TIME_ID])
+        cg.add(var.set_time(clock))
+
+    for conf in config.get(CONF_ON_REPLAY, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(
+            trigger, [(VehicleEvent, "event"), (cg.uint32, "timestamp")], conf
+        )
+
+    cg.add(ld2415h.register_listener(var))
+
+
+CALIBRATION_ACTION_SCHEMA = automation.maybe_simple_id(
+    {
+        cv.Required(CONF_ID): cv.use_id(Calibration),
+    }
+)
+
+
+@automation.register_action(
+    "ld2415h.calibration.start", CalibrationStartAction, CALIBRATION_ACTION_SCHEMA
+)
+@automation.register_action(
+    "ld2415h.calibration.cancel", CalibrationCancelAction, CALIBRATION_ACTION_SCHEMA
+)
+@automation.register_action(
+    "ld2415h.calibration.apply", CalibrationApplyAction, CALIBRATION_ACTION_SCHEMA
+)
+async def calibration_action_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+TRAFFIC_LOG_ACTION_SCHEMA = automation.maybe_simple_id(
+    {
+        cv.Required(CONF_ID): cv.use_id(TrafficLog),
+    }
+)
+
+
+@automation.register_action(
+    "ld2415h.traffic_log.dump", TrafficLogDumpAction, TRAFFIC_LOG_ACTION_SCHEMA
+)
+@automation.register_action(
+    "ld2415h.traffic_log.replay", TrafficLogReplayAction, TRAFFIC_LOG_ACTION_SCHEMA
+)
+@automation.register_action(
+    "ld2415h.traffic_log.clear", TrafficLogClearAction, TRAFFIC_LOG_ACTION_SCHEMA
+)
+async def traffic_log_action_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+CONFIGURE_ACTION_PARAMS = {
+    CONF_MIN_SPEED_THRESHOLD: cv.int_range(min=1, max=60),
+    CONF_COMPENSATION_ANGLE: cv.int_range(min=0, max=90),
+    CONF_SENSITIVITY: cv.int_range(min=1, max=15),
+    CONF_TRACKING_MODE: cv.enum(TRACKING_MODES),
+    CONF_SAMPLE_RATE: cv.enum(SAMPLE_RATES),
+    CONF_VIBRATION_CORRECTION: cv.int_range(min=0, max=112),
+    CONF_RELAY_TRIGGER_DURATION: cv.int_range(min=0, max=255),
+    CONF_RELAY_TRIGGER_SPEED: cv.int_range(min=0, max=255),
+}
+
+
+@automation.register_action(
+    "ld2415h.configure",
+    ConfigureAction,
+    cv.All(
+        cv.Schema(
+            {
+                cv.GenerateID(): cv.use_id(LD2415HComponent),
+                **{
+                    cv.Optional(key): cv.templatable(validator)
+                    for key, validator in CONFIGURE_ACTION_PARAMS.items()
+                },
+            }
+        ),
+        cv.has_at_least_one_key(*CONFIGURE_ACTION_PARAMS),
+    ),
+)
+async def configure_action_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    for key in CONFIGURE_ACTION_PARAMS:
+        if key in config:
+            value = await cg.templatable(config[key], args, cg.uint8)
+            cg.add(getattr(var, f"set_{key}")(value))
+    return var
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cmath>
+
+namespace esphome {
+namespace ld2415h {
+
+// Alpha-beta filter tracking a value and its rate of change. Alpha weights
+// the measurement residual into the value and beta into the rate; both are
+// fixed, so the filter needs no covariance state.
+class AlphaBetaFilter {
+ public:
+  void set_gains(float alpha, float beta) {
+    this->alpha_ = alpha;
+    this->beta_ = beta;
+  }
+
+  void reset(float value) {
+    this->value_ = value;
+    this->rate_ = 0.0f;
+  }
+
+  void update(float measurement, float dt) {
+    if (dt <= 0.0f)
+      return;
+
+    float predicted = this->value_ + this->rate_ * dt;
+    float residual = measurement - predicted;
+    this->value_ = predicted + this->alpha_ * residual;
+    this->rate_ += this->beta_ * residual / dt;
+  }
+
+  float value() const { return this->value_; }
+  float rate() const { return this->rate_; }
+
+ protected:
+  float alpha_{0.5f};
+  float beta_{0.1f};
+  float value_{0.0f};
+  float rate_{0.0f};
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include "calibration.h"
+#include "ld2415h.h"
+#include "traffic_log.h"
+
+namespace esphome {
+namespace ld2415h {
+
+class VehicleTrigger : public Trigger<VehicleEvent> {
+ public:
+  explicit VehicleTrigger(LD2415HComponent *parent) {
+    parent->add_on_vehicle_event_callback([this](VehicleEvent event) { this->trigger(event); });
+  }
+};
+
+// Applies several parameters as a single configuration write
+template<typename... Ts> class ConfigureAction : public Action<Ts...>, public Parented<LD2415HComponent> {
+ public:
+  TEMPLATABLE_VALUE(uint8_t, min_speed_threshold)
+  TEMPLATABLE_VALUE(uint8_t, compensation_angle)
+  TEMPLATABLE_VALUE(uint8_t, sensitivity)
+  TEMPLATABLE_VALUE(uint8_t, tracking_mode)
+  TEMPLATABLE_VALUE(uint8_t, sample_rate)
+  TEMPLATABLE_VALUE(uint8_t, vibration_correction)
+  TEMPLATABLE_VALUE(uint8_t, relay_trigger_duration)
+  TEMPLATABLE_VALUE(uint8_t, relay_trigger_speed)
+
+  void play(Ts... x) override {
+    this->parent_->begin_config();
+    if (this->min_speed_threshold_.has_value())
+      this->parent_->set_min_speed_threshold(this->min_speed_threshold_.value(x...));
+    if (this->compensation_angle_.has_value())
+      this->parent_->set_compensation_angle(this->compensation_angle_.value(x...));
+    if (this->sensitivity_.has_value())
+      this->parent_->set_sensitivity(this->sensitivity_.value(x...));
+    if (this->tracking_mode_.has_value())
+      this->parent_->set_tracking_mode(this->tracking_mode_.value(x...));
+    if (this->sample_rate_.has_value())
+      this->parent_->set_sample_rate(this->sample_rate_.value(x...));
+    if (this->vibration_correction_.has_value())
+      this->parent_->set_vibration_correction(this->vibration_correction_.value(x...));
+    if (this->relay_trigger_duration_.has_value())
+      this->parent_->set_relay_trigger_duration(this->relay_trigger_duration_.value(x...));
+    if (this->relay_trigger_speed_.has_value())
+      this->parent_->set_relay_trigger_speed(this->relay_trigger_speed_.value(x...));
+    this->parent_->end_config();
+  }
+};
+
+template<typename... Ts> class CalibrationStartAction : public Action<Ts...>, public Parented<Calibration> {
+ public:
+  void play(Ts... x) override { this->parent_->start(); }
+};
+
+template<typename... Ts> class CalibrationApplyAction : public Action<Ts...>, public Parented<Calibration> {
+ public:
+  void play(Ts... x) override { this->parent_->apply(); }
+};
+
+template<typename... Ts> class CalibrationCancelAction : public Action<Ts...>, public Parented<Calibration> {
+ public:
+  void play(Ts... x) override { this->parent_->cancel(); }
+};
+
+class TrafficLogReplayTrigger : public Trigger<VehicleEvent, uint32_t> {
+ public:
+  explicit TrafficLogReplayTrigger(TrafficLog *parent) {
+    parent->add_on_replay_callback([this](VehicleEvent event, uint32_t timestamp) { this->trigger(event, timestamp); });
+  }
+};
+
+template<typename... Ts> class TrafficLogDumpAction : public Action<Ts...>, public Parented<TrafficLog> {
+ public:
+  void play(Ts... x) override { this->parent_->dump(); }
+};
+
+template<typename... Ts> class TrafficLogReplayAction : public Action<Ts...>, public Parented<TrafficLog> {
+ public:
+  void play(Ts... x) override { this->parent_->replay(); }
+};
+
+template<typename... Ts> class TrafficLogClearAction : public Action<Ts...>, public Parented<TrafficLog> {
+ public:
+  void play(Ts... x) override { this->parent_->clear(); }
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -0,0 +1,215 @@
+#include "calibration.h"
+#include "fnv1a.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace ld2415h {
+
+static const char *const TAG = "LD2415H.calibration";
+
+static uint32_t calibration_hash(const CalibrationResult &result) {
+  const uint8_t settings[2] = {result.sensitivity, result.vibration_correction};
+  return fnv1a_hash(settings, sizeof(settings));
+}
+
+void Calibration::setup() {
+  this->pref_ = global_preferences->make_preference<CalibrationResult>(this->key_, true);
+  // The saved result is only reported here; the configured values stay in
+  // effect until apply() is requested
+  this->result_valid_ =
+      this->pref_.load(&this->result_) && this->result_.hash == calibration_hash(this->result_);
+}
+
+void Calibration::dump_config() {
+  ESP_LOGCONFIG(TAG, "LD2415H Calibration:");
+  ESP_LOGCONFIG(TAG, "  Settle Time: %u ms, Dwell Time: %u ms", this->settle_time_, this->dwell_time_);
+  ESP_LOGCONFIG(TAG, "  Sensitivity Step: %u, Vibration Correction Step: %u", this->sensitivity_step_,
+                this->vibration_correction_step_);
+  ESP_LOGCONFIG(TAG, "  Max False Rate: %.1f frames/min", this->max_false_rate_);
+  if (this->result_valid_) {
+    ESP_LOGCONFIG(TAG, "  Calibrated Sensitivity: %u, Vibration Correction: %u", this->result_.sensitivity,
+                  this->result_.vibration_correction);
+  } else {
+    ESP_LOGCONFIG(TAG, "  Not calibrated");
+  }
+}
+
+void Calibration::loop() {
+  uint32_t now = millis();
+
+  switch (this->state_) {
+    case CALIBRATION_APPLYING:
+      if (this->parent_->is_config_pending())
+        break;
+      this->state_ = CALIBRATION_SETTLING;
+      this->state_until_ = now + this->settle_time_;
+      break;
+
+    case CALIBRATION_SETTLING:
+      if (static_cast<int32_t>(now - this->state_until_) < 0)
+        break;
+      this->false_frames_ = 0;
+      this->detections_ = 0;
+      this->state_ = CALIBRATION_MEASURING;
+      this->state_until_ = now + this->dwell_time_;
+      break;
+
+    case CALIBRATION_MEASURING:
+      if (static_cast<int32_t>(now - this->state_until_) >= 0)
+        this->finish_step_();
+      break;
+
+    default:
+      break;
+  }
+}
+
+void Calibration::on_sample(const Sample &sample) {
+  if (this->state_ != CALIBRATION_MEASURING)
+    return;
+
+  if (this->jitter_count_ < UINT16_MAX && this->last_speed_ != 0) {
+    this->jitter_sum_ += std::abs(sample.speed - this->last_speed_);
+    this->jitter_count_++;
+  }
+  this->last_speed_ = sample.speed;
+}
+
+void Calibration::on_vehicle_event(const VehicleEvent &event) {
+  speed_t jitter = this->jitter_count_ > 0 ? this->jitter_sum_ / this->jitter_count_ : 0;
+  this->last_speed_ = 0;
+  this->jitter_sum_ = 0;
+  this->jitter_count_ = 0;
+
+  if (this->state_ != CALIBRATION_MEASURING)
+    return;
+
+  if (event.frame_count < this->min_frames_ || event.max_speed < this->noise_speed_ || jitter > this->noise_jitter_) {
+    this->false_frames_ += event.frame_count;
+  } else {
+    this->detections_++;
+  }
+}
+
+void Calibration::start() {
+  if (this->is_running()) {
+    ESP_LOGW(TAG, "Calibration already running");
+    return;
+  }
+
+  ESP_LOGI(TAG, "Starting calibration");
+  this->original_sensitivity_ = this->parent_->get_sensitivity();
+  this->original_vibration_correction_ = this->parent_->get_vibration_correction();
+  this->vibration_phase_ = false;
+  this->value_ = SENSITIVITY_RANGE.min;
+  this->best_valid_ = false;
+  this->apply_step_();
+}
+
+void Calibration::apply() {
+  if (this->is_running()) {
+    ESP_LOGW(TAG, "Calibration running, not applying the saved result");
+    return;
+  }
+  if (!this->result_valid_) {
+    ESP_LOGW(TAG, "No saved calibration to apply");
+    return;
+  }
+
+  ESP_LOGI(TAG, "Applying sensitivity %u, vibration correction %u", this->result_.sensitivity,
+           this->result_.vibration_correction);
+  this->parent_->begin_config();
+  this->parent_->set_sensitivity(this->result_.sensitivity);
+  this->parent_->set_vibration_correction(this->result_.vibration_correction);
+  this->parent_->end_config();
+}
+
+void Calibration::cancel() {
+  if (!this->is_running())
+    return;
+
+  ESP_LOGI(TAG, "Calibration cancelled");
+  this->state_ = CALIBRATION_IDLE;
+  this->parent_->begin_config();
+  this->parent_->set_sensitivity(this->original_sensitivity_);
+  this->parent_->set_vibration_correction(this->original_vibration_correction_);
+  this->parent_->end_config();
+}
+
+void Calibration::apply_step_() {
+  if (this->vibration_phase_) {
+    this->parent_->set_vibration_correction(this->value_);
+  } else {
+    this->parent_->set_sensitivity(this->value_);
+  }
+  this->state_ = CALIBRATION_APPLYING;
+}
+
+void Calibration::finish_step_() {
+  CalibrationScore score;
+  score.value = this->value_;
+  score.false_frames = this->false_frames_;
+  score.detections = this->detections_;
+  float rate = this->false_frames_ * 60000.0f / this->dwell_time_;
+  score.acceptable = rate <= this->max_false_rate_;
+
+  ESP_LOGI(TAG, "%s %u: %u false frames (%.1f/min), %u detections",
+           this->vibration_phase_ ? "Vibration correction" : "Sensitivity", score.value, score.false_frames, rate,
+           score.detections);
+
+  if (!this->best_valid_ || this->better_(score)) {
+    this->best_ = score;
+    this->best_valid_ = true;
+  }
+
+  if (!this->vibration_phase_) {
+    if (this->value_ + this->sensitivity_step_ <= SENSITIVITY_RANGE.max) {
+      this->value_ += this->sensitivity_step_;
+    } else {
+      // Keep the best sensitivity for the vibration correction sweep
+      ESP_LOGI(TAG, "Chose sensitivity %u", this->best_.value);
+      this->parent_->set_sensitivity(this->best_.value);
+      this->vibration_phase_ = true;
+      this->value_ = VIBRATION_CORRECTION_RANGE.min;
+      this->best_valid_ = false;
+    }
+    this->apply_step_();
+    return;
+  }
+
+  if (this->value_ + this->vibration_correction_step_ <= VIBRATION_CORRECTION_RANGE.max) {
+    this->value_ += this->vibration_correction_step_;
+    this->apply_step_();
+    return;
+  }
+
+  this->finish_();
+}
+
+bool Calibration::better_(const CalibrationScore &score) const {
+  if (score.acceptable != this->best_.acceptable)
+    return score.acceptable;
+  // Detections in a quiet period are passing traffic, not a measure of the
+  // setting, so among acceptable settings keep the first, which is the most
+  // sensitive since both sweeps start there. Otherwise keep the fewest false frames.
+  if (score.acceptable)
+    return false;
+  return score.false_frames < this->best_.false_frames;
+}
+
+void Calibration::finish_() {
+  this->state_ = CALIBRATION_IDLE;
+  this->result_.sensitivity = this->parent_->get_sensitivity();
+  this->result_.vibration_correction = this->best_.value;
+  this->result_.hash = calibration_hash(this->result_);
+  this->result_valid_ = this->pref_.save(&this->result_);
+  this->parent_->set_vibration_correction(this->best_.value);
+
+  ESP_LOGI(TAG, "Calibrated: sensitivity %u, vibration correction %u (%u false frames, %u detections)%s",
+           this->result_.sensitivity, this->result_.vibration_correction, this->best_.false_frames,
+           this->best_.detections, this->best_.acceptable ? "" : ", above the false frame limit");
+}
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/preferences.h"
+#include "ld2415h.h"
+
+namespace esphome {
+namespace ld2415h {
+
+enum CalibrationState : uint8_t {
+  CALIBRATION_IDLE,
+  CALIBRATION_APPLYING,  // Waiting for the read-back to confirm the step
+  CALIBRATION_SETTLING,  // Ignoring frames while the sensor adapts
+  CALIBRATION_MEASURING,
+};
+
+// Chosen setting, kept in flash until applied on request
+struct CalibrationResult {
+  uint8_t sensitivity;
+  uint8_t vibration_correction;
+  uint32_t hash;
+};
+
+// Score of one candidate setting over its measuring window
+struct CalibrationScore {
+  uint8_t value;
+  uint32_t false_frames;
+  uint32_t detections;
+  bool acceptable;  // False frame rate within the limit
+};
+
+// Finds the most sensitive sensitivity and vibration correction whose false
+// frame rate during a quiet period is within the limit. Sensitivity is swept
+// first with the current vibration correction, then vibration correction with
+// the chosen sensitivity, each from its most sensitive end. Events that are too
+// short, too slow or too jittery to be a vehicle count as false frames; the
+// rest are passing traffic and only reported. Nothing changes the sensor's
+// setting except a requested sweep, cancel() or apply().
+class Calibration : public LD2415HListener, public Component, public Parented<LD2415HComponent> {
+ public:
+  void setup() override;
+  void dump_config() override;
+  void loop() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  void set_id(const std::string &id) { this->key_ = fnv1_hash("ld2415h_calibration_" + id); }
+  void set_settle_time(uint32_t settle_time) { this->settle_time_ = settle_time; }
+  void set_dwell_time(uint32_t dwell_time) { this->dwell_time_ = dwell_time; }
+  void set_sensitivity_step(uint8_t step) { this->sensitivity_step_ = step; }
+  void set_vibration_correction_step(uint8_t step) { this->vibration_correction_step_ = step; }
+  void set_max_false_rate(float rate) { this->max_false_rate_ = rate; }
+  void set_noise_speed(speed_t speed) { this->noise_speed_ = speed; }
+  void set_noise_jitter(speed_t jitter) { this->noise_jitter_ = jitter; }
+  void set_min_frames(uint16_t frames) { this->min_frames_ = frames; }
+
+  void on_sample(const Sample &sample) override;
+  void on_vehicle_event(const VehicleEvent &event) override;
+
+  void start();
+  // Apply the saved result of the last sweep
+  void apply();
+  // Stop and restore the setting from before the sweep
+  void cancel();
+  bool is_running() const { return this->state_ != CALIBRATION_IDLE; }
+
+ protected:
+  void apply_step_();
+  void finish_step_();
+  void finish_();
+  bool better_(const CalibrationScore &score) const;
+
+  uint32_t key_{0};
+  uint32_t settle_time_{5000};
+  uint32_t dwell_time_{30000};
+  uint8_t sensitivity_step_{2};
+  uint8_t vibration_correction_step_{16};
+  float max_false_rate_{1.0f};  // Frames per minute
+  speed_t noise_speed_{50};
+  speed_t noise_jitter_{50};
+  uint16_t min_frames_{3};
+
+  ESPPreferenceObject pref_;
+  CalibrationResult result_{};
+  bool result_valid_{false};
+
+  CalibrationState state_{CALIBRATION_IDLE};
+  bool vibration_phase_{false};
+  uint8_t value_{0};  // Value of the current step
+  uint32_t state_until_{0};
+  uint8_t original_sensitivity_{0};
+  uint8_t original_vibration_correction_{0};
+
+  // Counts for the current step
+  uint32_t false_frames_{0};
+  uint32_t detections_{0};
+  CalibrationScore best_{};
+  bool best_valid_{false};
+
+  // Frame to frame speed change within the current event
+  speed_t last_speed_{0};
+  uint32_t jitter_sum_{0};
+  uint16_t jitter_count_{0};
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace esphome {
+namespace ld2415h {
+
+enum CommandId : uint8_t {
+  CMD_SET_SPEED_ANGLE_SENSE = 0x01,
+  CMD_SET_MODE_RATE_UOM = 0x02,
+  CMD_SET_ANTI_VIB_COMP = 0x03,
+  CMD_SET_RELAY_DURATION_SPEED = 0x04,
+  CMD_GET_CONFIG = 0x07,
+};
+
+struct ParamRange {
+  uint8_t min;
+  uint8_t max;
+
+  constexpr bool contains(uint8_t value) const { return value >= this->min && value <= this->max; }
+};
+
+// Accepted parameter ranges, matching the limits of the number and select entities
+static constexpr ParamRange MIN_SPEED_THRESHOLD_RANGE{1, 60};
+static constexpr ParamRange COMPENSATION_ANGLE_RANGE{0, 90};
+static constexpr ParamRange SENSITIVITY_RANGE{1, 15};
+static constexpr ParamRange TRACKING_MODE_RANGE{0, 2};
+static constexpr ParamRange SAMPLE_RATE_RANGE{0, 2};
+static constexpr ParamRange UNIT_OF_MEASURE_RANGE{0, 2};
+static constexpr ParamRange VIBRATION_CORRECTION_RANGE{0, 112};
+static constexpr ParamRange RELAY_TRIGGER_DURATION_RANGE{0, 255};
+static constexpr ParamRange RELAY_TRIGGER_SPEED_RANGE{0, 255};
+
+// Logs and clamps an out of range parameter at runtime. Not constexpr, so reaching
+// it while encoding a constant command is a compile error.
+uint8_t param_out_of_range(uint8_t value, ParamRange range);
+
+constexpr uint8_t check_param(uint8_t value, ParamRange range) {
+  return range.contains(value) ? value : param_out_of_range(value, range);
+}
+
+// Byte layout of a command: "CF", the command identifier, the parameters and an
+// optional "\r\n" terminator.
+template<CommandId ID, uint8_t PARAMS, bool TERMINATED> struct CommandLayout {
+  static constexpr uint8_t SIZE = 3 + PARAMS + (TERMINATED ? 2 : 0);
+  using Bytes = std::array<uint8_t, SIZE>;
+  using Params = std::array<uint8_t, PARAMS>;
+
+  static constexpr Bytes encode(const Params &params) {
+    Bytes cmd{};
+    cmd[0] = 0x43;
+    cmd[1] = 0x46;
+    cmd[2] = ID;
+    for (uint8_t i = 0; i < PARAMS; i++)
+      cmd[3 + i] = params[i];
+    if (TERMINATED) {
+      cmd[SIZE - 2] = 0x0d;
+      cmd[SIZE - 1] = 0x0a;
+    }
+    return cmd;
+  }
+};
+
+// Set commands that together cover the whole sensor configuration
+static constexpr CommandId SET_COMMANDS[] = {CMD_SET_SPEED_ANGLE_SENSE, CMD_SET_MODE_RATE_UOM, CMD_SET_ANTI_VIB_COMP,
+                                             CMD_SET_RELAY_DURATION_SPEED};
+
+using SpeedAngleSenseCommand = CommandLayout<CMD_SET_SPEED_ANGLE_SENSE, 3, true>;
+using ModeRateUomCommand = CommandLayout<CMD_SET_MODE_RATE_UOM, 3, true>;
+using AntiVibCompCommand = CommandLayout<CMD_SET_ANTI_VIB_COMP, 3, true>;
+using RelayDurationSpeedCommand = CommandLayout<CMD_SET_RELAY_DURATION_SPEED, 3, true>;
+using GetConfigCommand = CommandLayout<CMD_GET_CONFIG, 10, false>;
+
+static constexpr GetConfigCommand::Bytes CMD_GET_CONFIG_BYTES = GetConfigCommand::encode({});
+
+// Standard Protocol frames are delimited by these bytes. The payload format
+// is not documented, so the negotiation mode is never written, but the frames
+// are still read from a sensor left in that mode.
+static const uint8_t FRAME_START = 0xFA;
+static const uint8_t FRAME_END = 0xFB;
+
+// Largest burst: every set command followed by a configuration read
+static constexpr uint8_t MAX_COMMAND_BURST = SpeedAngleSenseCommand::SIZE + ModeRateUomCommand::SIZE +
+                                             AntiVibCompCommand::SIZE + RelayDurationSpeedCommand::SIZE +
+                                             GetConfigCommand::SIZE;
+
+// Datasheet example commands, checked at compile time
+static_assert(SpeedAngleSenseCommand::encode({check_param(0x01, MIN_SPEED_THRESHOLD_RANGE),
+                                              check_param(0x00, COMPENSATION_ANGLE_RANGE),
+                                              check_param(0x05, SENSITIVITY_RANGE)})[5] == 0x05,
+              "Invalid speed/angle/sensitivity command");
+static_assert(CMD_GET_CONFIG_BYTES.size() == 13 && CMD_GET_CONFIG_BYTES[2] == CMD_GET_CONFIG,
+              "Invalid get config command");
+
+static const uint8_t READBACK_NONE = 0xFF;
+
+// Configuration read-back key (X1..X0) reporting each parameter of a set command
+constexpr uint8_t readback_key(CommandId id, uint8_t param) {
+  switch (id) {
+    case CMD_SET_SPEED_ANGLE_SENSE:
+      return 1 + param;
+    case CMD_SET_MODE_RATE_UOM:
+      return 4 + param;
+    case CMD_SET_ANTI_VIB_COMP:
+      return param == 0 ? 7 : READBACK_NONE;
+    case CMD_SET_RELAY_DURATION_SPEED:
+      return param < 2 ? 8 + param : READBACK_NONE;
+    default:
+      return READBACK_NONE;
+  }
+}
+
+static_assert(readback_key(CMD_SET_MODE_RATE_UOM, 1) == 5, "Sample rate is reported as X5");
+
+template<size_t N> inline uint8_t append_command(uint8_t *buffer, const std::array<uint8_t, N> &cmd) {
+  std::memcpy(buffer, cmd.data(), N);
+  return N;
+}
+
+}  // namespace ld2415h
+}  // namespace esphome
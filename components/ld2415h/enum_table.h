@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace esphome {
+namespace ld2415h {
+
+// Display names of an enum, indexed by value - FIRST. Constant initialised, so
+// no constructor runs at boot. The names of the select tables must match the
+// option lists in __init__.py; test_enum_names.py in tests/host checks this.
+template<uint8_t N> struct EnumTable {
+  uint8_t first;
+  const char *names[N];
+
+  static constexpr uint8_t size() { return N; }
+
+  constexpr bool contains(uint8_t value) const { return value >= this->first && value - this->first < N; }
+
+  constexpr const char *to_str(uint8_t value) const {
+    return this->contains(value) ? this->names[value - this->first] : "Unknown";
+  }
+
+  // Value for a display name, or -1 when there is none
+  int16_t find(const std::string &name) const {
+    for (uint8_t i = 0; i < N; i++) {
+      if (std::strcmp(this->names[i], name.c_str()) == 0)
+        return this->first + i;
+    }
+    return -1;
+  }
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace ld2415h {
+
+static const uint32_t FNV1A_OFFSET_BASIS = 2166136261UL;
+static const uint32_t FNV1A_PRIME = 16777619UL;
+
+// 32-bit FNV-1a over a block of bytes, used to validate records kept in
+// flash. Pass the previous result as hash to continue over several blocks.
+// esphome::fnv1_hash() is FNV-1 over a string, so it cannot replace this
+// without invalidating stored records.
+inline uint32_t fnv1a_hash(const uint8_t *data, size_t len, uint32_t hash = FNV1A_OFFSET_BASIS) {
+  for (size_t i = 0; i < len; i++)
+    hash = (hash ^ data[i]) * FNV1A_PRIME;
+  return hash;
+}
+
+}  // namespace ld2415h
+}  // namespace esphome
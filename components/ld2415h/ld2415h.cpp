@@ -1,4 +1,5 @@
 #include "ld2415h.h"
+#include "fnv1a.h"
 #include "esphome/core/log.h"
 
 namespace esphome {
@@ -6,20 +7,65 @@ namespace ld2415h {
 
 static const char *const TAG = "ld2415h";
 
+#ifdef USE_LD2415H_PROFILING
+static const char *const PROFILE_PATH_NAMES[PROFILE_COUNT] = {"fill", "decode", "dispatch", "config"};
+#endif
+
+// Read-back keys X0..X9
+static const char *const CONFIG_PARAM_NAMES[CONFIG_PARAM_COUNT] = {
+    "Negotiation Mode", "Minimum Speed Threshold", "Compensation Angle",   "Sensitivity",
+    "Tracking Mode",    "Sampling Rate",           "Unit of Measure",      "Vibration Correction",
+    "Relay Trigger Duration", "Relay Trigger Speed",
+};
+
 LD2415HComponent::LD2415HComponent() {}
 
 void LD2415HComponent::setup() {
-  // This triggers current sensor configurations to be dumped
+  // The governor starts at its idle rate until traffic appears
+  if (this->governor_enabled_)
+    this->sample_rate_ = this->governor_.target();
+
+  this->boot_time_ = millis();
+
+  if (this->speed_trigger_.is_configured())
+    this->speed_trigger_.setup();
+
+  // Apply the configured values, then dump the current sensor configuration.
+  // With a cached configuration only the commands that differ from it are sent,
+  // and the read-back decides whether any others are needed.
+  bool cached = this->load_config_cache_();
+  for (CommandId id : SET_COMMANDS) {
+    uint8_t params[3];
+    this->command_params_(id, params);
+    if (!cached || !this->readback_matches_(id, params, this->config_cache_.config, this->config_cache_.mask))
+      this->queue_command_(id);
+  }
+  this->config_reconcile_pending_ = cached;
   this->update_config_ = true;
-  // Setup the listener to publish so we can publish config state on connect.
 
-  // Publish initial values or configuration state
-  if (this->speed_sensor_ != nullptr)
-    this->speed_sensor_->publish_state(this->speed_);
+  if (!this->batch_listeners_.empty()) {
+    this->batch_ = std::unique_ptr<Sample[]>(new Sample[this->batch_size_]);
+    if (this->batch_interval_ > 0)
+      this->set_interval("batch", this->batch_interval_, [this]() { this->flush_batch_(); });
+  }
 
-  if (this->velocity_sensor_ != nullptr)
-    this->velocity_sensor_->publish_state(this->velocity_);
+  if (this->diagnostics_interval_ > 0)
+    this->set_interval("diagnostics", this->diagnostics_interval_, [this]() { this->publish_diagnostics_(); });
+
+#ifdef USE_ESP32
+  if (this->reader_task_core_ >= 0) {
+    this->reader_task_running_ = true;
+    BaseType_t result = xTaskCreatePinnedToCore(LD2415HComponent::reader_task_, "ld2415h", 4096, this,
+                                                this->reader_task_priority_, &this->reader_task_handle_,
+                                                this->reader_task_core_);
+    if (result != pdPASS) {
+      ESP_LOGE(TAG, "Failed to start reader task, reading from loop()");
+      this->reader_task_running_ = false;
+    }
+  }
+#endif
 
+  // Publish initial configuration state
   #ifdef USE_NUMBER
   if (this->min_speed_threshold_number_ != nullptr)
       this->min_speed_threshold_number_->publish_state(this->min_speed_threshold_);
@@ -37,9 +83,9 @@ void LD2415HComponent::setup() {
 
   #ifdef USE_SELECT
   if (this->tracking_mode_selector_ != nullptr)
-      this->tracking_mode_selector_->publish_state(this->i_to_s_(TRACKING_MODE_STR_TO_INT, this->tracking_mode_));
+      this->tracking_mode_selector_->publish_state(TRACKING_MODE_NAMES.to_str(this->tracking_mode_));
   if (this->sample_rate_selector_ != nullptr)
-      this->sample_rate_selector_->publish_state(this->i_to_s_(SAMPLE_RATE_STR_TO_INT, this->sample_rate_));
+      this->sample_rate_selector_->publish_state(SAMPLE_RATE_NAMES.to_str(this->sample_rate_));
   #endif
 
 }
@@ -50,142 +96,559 @@ void LD2415HComponent::dump_config() {
   ESP_LOGCONFIG(TAG, "  Minimum Speed Threshold: %u KPH", this->min_speed_threshold_);
   ESP_LOGCONFIG(TAG, "  Compensation Angle: %u", this->compensation_angle_);
   ESP_LOGCONFIG(TAG, "  Sensitivity: %u", this->sensitivity_);
-  ESP_LOGCONFIG(TAG, "  Tracking Mode: %s", this->i_to_s_(TRACKING_MODE_STR_TO_INT, this->tracking_mode_));
-  ESP_LOGCONFIG(TAG, "  Sampling Rate: %s", this->i_to_s_(SAMPLE_RATE_STR_TO_INT, this->sample_rate_));
-  ESP_LOGCONFIG(TAG, "  Unit of Measure: %s", this->i_to_s_(UNIT_OF_MEASURE_STR_TO_INT, this->unit_of_measure_));
+  ESP_LOGCONFIG(TAG, "  Tracking Mode: %s", TRACKING_MODE_NAMES.to_str(this->tracking_mode_));
+  ESP_LOGCONFIG(TAG, "  Sampling Rate: %s", SAMPLE_RATE_NAMES.to_str(this->sample_rate_));
+  ESP_LOGCONFIG(TAG, "  Unit of Measure: %s", UNIT_OF_MEASURE_NAMES.to_str(this->unit_of_measure_));
   ESP_LOGCONFIG(TAG, "  Vibration Correction: %u", this->vibration_correction_);
   ESP_LOGCONFIG(TAG, "  Relay Trigger Duration: %u", this->relay_trigger_duration_);
   ESP_LOGCONFIG(TAG, "  Relay Trigger Speed: %u KPH", this->relay_trigger_speed_);
-  ESP_LOGCONFIG(TAG, "  Negotiation Mode: %s", this->i_to_s_(NEGOTIATION_MODE_STR_TO_INT, this->negotiation_mode_));
-}
-
-void LD2415HComponent::loop() {
-  // Process the stream from the sensor UART
-  while (this->available()) {
-    if (this->fill_buffer_(this->read())) {
-      this->parse_buffer_();
+  ESP_LOGCONFIG(TAG, "  Negotiation Mode: %s", NEGOTIATION_MODE_NAMES.to_str(this->negotiation_mode_.load()));
+  if (this->negotiation_mode_.load() == NegotiationMode::STANDARD_PROTOCOL) {
+    ESP_LOGCONFIG(TAG, "  Framed Payloads: %u", this->framed_payloads_.load());
+    ESP_LOGCONFIG(TAG, "  Unknown Payloads: %u", this->unknown_payloads_.load());
+  }
+#ifdef USE_ESP32
+  if (this->reader_task_running_) {
+    ESP_LOGCONFIG(TAG, "  Reader Task: core %d, priority %u", this->reader_task_core_, this->reader_task_priority_);
+    ESP_LOGCONFIG(TAG, "  Sample Ring Capacity: %u", this->sample_ring_.capacity());
+  }
+#endif
+  if (this->governor_enabled_) {
+    ESP_LOGCONFIG(TAG, "  Sample Rate Governor: active %s, idle %s, hold %u ms",
+                  SAMPLE_RATE_NAMES.to_str(this->governor_.active_rate()),
+                  SAMPLE_RATE_NAMES.to_str(this->governor_.idle_rate()), this->governor_.hold_time());
+    for (uint8_t rate = 0; rate < SAMPLE_RATE_COUNT; rate++) {
+      ESP_LOGCONFIG(TAG, "    Time at %s: %u s", SAMPLE_RATE_NAMES.to_str(rate),
+                    (uint32_t) (this->governor_.time_at(rate) / 1000));
     }
   }
-
-  if (this->update_speed_angle_sense_) {
-    ESP_LOGD(TAG, "LD2415H_CMD_SET_SPEED_ANGLE_SENSE: ");
-    this->cmd_set_speed_angle_sense_[3] = this->min_speed_threshold_;
-    this->cmd_set_speed_angle_sense_[4] = this->compensation_angle_;
-    this->cmd_set_speed_angle_sense_[5] = this->sensitivity_;
-
-    this->issue_command_(this->cmd_set_speed_angle_sense_, sizeof(this->cmd_set_speed_angle_sense_));
-    this->update_speed_angle_sense_ = false;
-    return;
+  if (this->speed_trigger_.is_configured()) {
+    static const char *const DIRECTIONS[] = {"Any", "Approaching", "Retreating"};
+    LOG_PIN("  Speed Trigger Pin: ", this->speed_trigger_.get_pin());
+    ESP_LOGCONFIG(TAG, "    Speed: %.1f, Hysteresis: %.1f, Direction: %s, Hold: %u ms",
+                  speed_to_float(this->speed_trigger_.get_speed()),
+                  speed_to_float(this->speed_trigger_.get_hysteresis()),
+                  DIRECTIONS[this->speed_trigger_.get_direction()], this->speed_trigger_.get_hold_time());
+    ESP_LOGCONFIG(TAG, "    Activations: %u, Last Latency: %u us", this->trigger_activations_.load(),
+                  this->trigger_latency_last_.load());
   }
-
-  if (this->update_mode_rate_uom_) {
-    ESP_LOGD(TAG, "LD2415H_CMD_SET_MODE_RATE_UOM: ");
-    this->cmd_set_mode_rate_uom_[3] = static_cast<uint8_t>(this->tracking_mode_);
-    this->cmd_set_mode_rate_uom_[4] = this->sample_rate_;
-
-    this->issue_command_(this->cmd_set_mode_rate_uom_, sizeof(this->cmd_set_mode_rate_uom_));
-    this->update_mode_rate_uom_ = false;
-    return;
+  if (this->config_cache_enabled_)
+    ESP_LOGCONFIG(TAG, "  Configuration Cache: %s", this->config_cache_valid_ ? "valid" : "empty");
+  if (this->configured_)
+    ESP_LOGCONFIG(TAG, "  Time to Configured: %u ms", this->configured_time_);
+  if (this->first_sample_received_)
+    ESP_LOGCONFIG(TAG, "  Time to First Sample: %u ms", this->first_sample_time_);
+  ESP_LOGCONFIG(TAG, "  Vehicle Event Gap: %u ms", this->event_gap_);
+  if (this->vehicle_tracker_.get_max_tracks() > 1) {
+    speed_t gate = this->vehicle_tracker_.get_gate();
+    ESP_LOGCONFIG(TAG, "  Vehicle Tracks: %u, Gate: %d.%d", this->vehicle_tracker_.get_max_tracks(), gate / 10,
+                  gate % 10);
   }
+  ESP_LOGCONFIG(TAG, "  Dropped Frames: %u", this->dropped_frames_.load());
+  ESP_LOGCONFIG(TAG, "  Command Retries: %u", this->command_retries_);
+  ESP_LOGCONFIG(TAG, "  Command Failures: %u", this->command_failures_);
+  ESP_LOGCONFIG(TAG, "  Configuration Debounce: %u ms", this->config_debounce_);
+  ESP_LOGCONFIG(TAG, "  Configuration Writes: %u", this->config_writes_);
+  ESP_LOGCONFIG(TAG, "  Frames Lost to Reconfiguration: %u", this->reconfig_lost_frames_);
+  ESP_LOGCONFIG(TAG, "  Buffer Overruns: %u", this->buffer_overruns_.load());
+  ESP_LOGCONFIG(TAG, "  Unknown Frames: %u", this->unknown_frames_.load());
+  ESP_LOGCONFIG(TAG, "  Parse Failures: %u", this->parse_failures_.load());
+  if (this->frame_interval_.count() > 1) {
+    ESP_LOGCONFIG(TAG, "  Frame Interval: mean %.2f ms, jitter %.2f ms", this->frame_interval_.mean() / 1000.0f,
+                  this->frame_interval_.stddev() / 1000.0f);
+  }
+  if (this->publish_latency_.count() > 0) {
+    ESP_LOGCONFIG(TAG, "  Publish Latency: mean %.2f ms, max %.2f ms", this->publish_latency_.mean() / 1000.0f,
+                  this->publish_latency_.max() / 1000.0f);
+  }
+  if (this->loop_drain_.count() > 0) {
+    ESP_LOGCONFIG(TAG, "  Loop Drain Time: mean %.2f ms, max %.2f ms", this->loop_drain_.mean() / 1000.0f,
+                  this->loop_drain_.max() / 1000.0f);
+  }
+#ifdef USE_SENSOR
+  LOG_SENSOR("  ", "Dropped Frames", this->dropped_frames_sensor_);
+  LOG_SENSOR("  ", "Command Latency", this->command_latency_sensor_);
+  LOG_SENSOR("  ", "Command Retries", this->command_retries_sensor_);
+  LOG_SENSOR("  ", "Command Failures", this->command_failures_sensor_);
+  LOG_SENSOR("  ", "Buffer Overruns", this->buffer_overruns_sensor_);
+  LOG_SENSOR("  ", "Unknown Frames", this->unknown_frames_sensor_);
+  LOG_SENSOR("  ", "Parse Failures", this->parse_failures_sensor_);
+  LOG_SENSOR("  ", "Frame Jitter", this->frame_jitter_sensor_);
+  LOG_SENSOR("  ", "Publish Latency", this->publish_latency_sensor_);
+  LOG_SENSOR("  ", "Loop Drain Time", this->loop_drain_time_sensor_);
+  for (auto *sensor : this->sample_rate_time_sensors_)
+    LOG_SENSOR("  ", "Sample Rate Time", sensor);
+#endif
+  if (!this->batch_listeners_.empty()) {
+    ESP_LOGCONFIG(TAG, "  Batch Size: %u", this->batch_size_);
+    ESP_LOGCONFIG(TAG, "  Batch Interval: %u ms", this->batch_interval_);
+  }
+}
 
-  if (this->update_anti_vib_comp_) {
-    ESP_LOGD(TAG, "LD2415H_CMD_SET_ANTI_VIB_COMP: ");
-    this->cmd_set_anti_vib_comp_[3] = this->vibration_correction_;
+void LD2415HComponent::loop() {
+  uint32_t drain_start = micros();
+  size_t drained = 0;
+
+#ifdef USE_ESP32
+  if (this->reader_task_running_) {
+    // Drain frames decoded by the reader task
+    Sample sample;
+    while (this->sample_ring_.pop(sample)) {
+      this->process_sample_(sample);
+      drained++;
+    }
 
-    this->issue_command_(this->cmd_set_anti_vib_comp_, sizeof(this->cmd_set_anti_vib_comp_));
-    this->update_anti_vib_comp_ = false;
-    return;
+    Response response;
+    while (this->response_ring_.pop(response)) {
+      drained++;
+      if (response.type == FrameType::FRAME_CONFIG) {
+        this->parse_config_(response.valid, response.config, response.config_mask);
+      } else if (response.type == FrameType::FRAME_FIRMWARE) {
+        this->parse_firmware_(response.text);
+      }
+    }
+  } else
+#endif
+  {
+    // Process the stream from the sensor UART
+    drained = this->read_uart_();
   }
 
-  if (this->update_relay_duration_speed_) {
-    ESP_LOGD(TAG, "LD2415H_CMD_SET_RELAY_DURATION_SPEED: ");
-    this->cmd_set_relay_duration_speed_[3] = this->relay_trigger_duration_;
-    this->cmd_set_relay_duration_speed_[4] = this->relay_trigger_speed_;
+  if (drained > 0)
+    this->loop_drain_.add(micros() - drain_start);
 
-    this->issue_command_(this->cmd_set_relay_duration_speed_, sizeof(this->cmd_set_relay_duration_speed_));
-    this->update_relay_duration_speed_ = false;
-    return;
-  }
+  this->vehicle_tracker_.expire(millis(), [this](const VehicleEvent &event) { this->close_vehicle_event_(event); });
 
-  if (this->update_config_) {
-    ESP_LOGD(TAG, "LD2415H_CMD_GET_CONFIG: ");
+  this->update_governor_(millis());
 
-    this->issue_command_(this->cmd_get_config_, sizeof(this->cmd_get_config_));
-    this->update_config_ = false;
-    return;
-  }
+  this->process_commands_();
 }
 
 
-#ifdef USE_NUMBER
+// Entity and automation changes are staged and sent together once they settle
 void LD2415HComponent::set_min_speed_threshold(uint8_t speed) {
   this->min_speed_threshold_ = speed;
-  this->update_speed_angle_sense_ = true;
+  this->stage_command_(CMD_SET_SPEED_ANGLE_SENSE);
 }
 
 void LD2415HComponent::set_compensation_angle(uint8_t angle) {
   this->compensation_angle_ = angle;
-  this->update_speed_angle_sense_ = true;
+  this->stage_command_(CMD_SET_SPEED_ANGLE_SENSE);
 }
 
 void LD2415HComponent::set_sensitivity(uint8_t sensitivity) {
   this->sensitivity_ = sensitivity;
-  this->update_speed_angle_sense_ = true;
+  this->stage_command_(CMD_SET_SPEED_ANGLE_SENSE);
 }
 
 void LD2415HComponent::set_vibration_correction(uint8_t correction) {
   this->vibration_correction_ = correction;
-  this->update_anti_vib_comp_ = true;
+  this->stage_command_(CMD_SET_ANTI_VIB_COMP);
 }
 
 void LD2415HComponent::set_relay_trigger_duration(uint8_t duration) {
   this->relay_trigger_duration_ = duration;
-  this->update_relay_duration_speed_ = true;
+  this->stage_command_(CMD_SET_RELAY_DURATION_SPEED);
 }
 
 void LD2415HComponent::set_relay_trigger_speed(uint8_t speed) {
   this->relay_trigger_speed_ = speed;
-  this->update_relay_duration_speed_ = true;
-}
-#endif
-
-#ifdef USE_SELECT
-void LD2415HComponent::set_tracking_mode(const std::string &state) {
-  uint8_t mode = TRACKING_MODE_STR_TO_INT.at(state);
-  this->set_tracking_mode(mode);
-  this->tracking_mode_selector_->publish_state(state);
+  this->stage_command_(CMD_SET_RELAY_DURATION_SPEED);
 }
 
 void LD2415HComponent::set_tracking_mode(TrackingMode mode) {
   this->tracking_mode_ = mode;
-  this->update_mode_rate_uom_ = true;
+  this->stage_command_(CMD_SET_MODE_RATE_UOM);
 }
 
 void LD2415HComponent::set_tracking_mode(uint8_t mode) { this->set_tracking_mode(i_to_tracking_mode_(mode)); }
 
+void LD2415HComponent::set_sample_rate(uint8_t rate) {
+  ESP_LOGD(TAG, "set_sample_rate: %i", rate);
+  this->sample_rate_ = rate;
+  this->stage_command_(CMD_SET_MODE_RATE_UOM);
+}
+
+void LD2415HComponent::begin_config() { this->config_batch_depth_++; }
+
+void LD2415HComponent::end_config() {
+  if (this->config_batch_depth_ == 0 || --this->config_batch_depth_ > 0)
+    return;
+  // Send the whole batch at the next idle point without waiting out the debounce
+  this->config_hold_started_ = false;
+}
+
+#ifdef USE_SELECT
+void LD2415HComponent::set_tracking_mode(const std::string &state) {
+  int16_t mode = TRACKING_MODE_NAMES.find(state);
+  if (mode < 0) {
+    ESP_LOGE(TAG, "Invalid Tracking Mode: %s", state.c_str());
+    return;
+  }
+  this->set_tracking_mode(static_cast<uint8_t>(mode));
+  this->tracking_mode_selector_->publish_state(state);
+}
+
 void LD2415HComponent::set_sample_rate(const std::string &state) {
-  uint8_t rate = SAMPLE_RATE_STR_TO_INT.at(state);
-  this->set_sample_rate(rate);
+  int16_t rate = SAMPLE_RATE_NAMES.find(state);
+  if (rate < 0) {
+    ESP_LOGE(TAG, "Invalid Sample Rate: %s", state.c_str());
+    return;
+  }
+  this->set_sample_rate(static_cast<uint8_t>(rate));
   this->sample_rate_selector_->publish_state(state);
 }
+#endif
 
-void LD2415HComponent::set_sample_rate(uint8_t rate) {
-  ESP_LOGD(TAG, "set_sample_rate: %i", rate);
-  this->sample_rate_ = rate;
-  this->update_mode_rate_uom_ = true;
+uint8_t param_out_of_range(uint8_t value, ParamRange range) {
+  ESP_LOGW(TAG, "Parameter %u outside %u-%u, clamping", value, range.min, range.max);
+  return value < range.min ? range.min : range.max;
+}
+
+void LD2415HComponent::queue_command_(CommandId id) {
+  PendingCommand *command = nullptr;
+
+  // Merge with a queued command of the same type so only the latest values are sent
+  for (uint8_t i = 0; i < this->command_queue_count_; i++) {
+    if (this->command_queue_[i].id == id)
+      command = &this->command_queue_[i];
+  }
+
+  if (command == nullptr) {
+    if (this->command_queue_count_ >= COMMAND_QUEUE_SIZE) {
+      ESP_LOGE(TAG, "Command queue full, dropping command 0x%02x", id);
+      return;
+    }
+    command = &this->command_queue_[this->command_queue_count_++];
+    command->id = id;
+  }
+
+  command->attempts = 0;
+  this->command_params_(id, command->params);
+}
+
+void LD2415HComponent::stage_command_(CommandId id) {
+  this->queue_command_(id);
+  if (this->config_batch_depth_ > 0 || this->config_debounce_ == 0)
+    return;
+
+  // Each change restarts the window, but a continuous slider drag is still
+  // applied every CONFIG_DEBOUNCE_MAX_WINDOWS windows
+  uint32_t now = millis();
+  if (!this->config_hold_started_) {
+    this->config_hold_started_ = true;
+    this->config_hold_start_ = now;
+  }
+  this->config_hold_last_ = now;
 }
+
+void LD2415HComponent::command_params_(CommandId id, uint8_t params[3]) {
+  switch (id) {
+    case CMD_SET_SPEED_ANGLE_SENSE:
+      params[0] = check_param(this->min_speed_threshold_, MIN_SPEED_THRESHOLD_RANGE);
+      params[1] = check_param(this->compensation_angle_, COMPENSATION_ANGLE_RANGE);
+      params[2] = check_param(this->sensitivity_, SENSITIVITY_RANGE);
+      break;
+    case CMD_SET_MODE_RATE_UOM:
+      params[0] = check_param(this->tracking_mode_, TRACKING_MODE_RANGE);
+      params[1] = check_param(this->sample_rate_, SAMPLE_RATE_RANGE);
+      params[2] = UnitOfMeasure::KPH;
+      break;
+    case CMD_SET_ANTI_VIB_COMP:
+      params[0] = check_param(this->vibration_correction_, VIBRATION_CORRECTION_RANGE);
+      params[1] = 0x00;
+      params[2] = 0x00;
+      break;
+    case CMD_SET_RELAY_DURATION_SPEED:
+      params[0] = check_param(this->relay_trigger_duration_, RELAY_TRIGGER_DURATION_RANGE);
+      params[1] = check_param(this->relay_trigger_speed_, RELAY_TRIGGER_SPEED_RANGE);
+      params[2] = 0x00;
+      break;
+    default:
+      break;
+  }
+}
+
+void LD2415HComponent::process_commands_() {
+  uint32_t now = millis();
+
+  if (this->command_awaiting_readback_) {
+    if (now - this->command_sent_ < COMMAND_TIMEOUT)
+      return;
+
+    ESP_LOGW(TAG, "Configuration read-back timed out");
+    this->command_awaiting_readback_ = false;
+    this->retry_commands_();
+    return;
+  }
+
+  if (this->command_queue_count_ == 0 && !this->update_config_)
+    return;
+
+  if (this->command_backoff_ > 0) {
+    if (now - this->command_backoff_start_ < this->command_backoff_)
+      return;
+    this->command_backoff_ = 0;
+  }
+
+  // Staged changes wait for the batch to close and the debounce to expire
+  if (this->config_batch_depth_ > 0)
+    return;
+  if (this->config_hold_started_ && now - this->config_hold_last_ < this->config_debounce_ &&
+      now - this->config_hold_start_ < this->config_debounce_ * CONFIG_DEBOUNCE_MAX_WINDOWS)
+    return;
+  this->config_hold_started_ = false;
+
+  // Only transmit between frames
+  if (this->receiving_)
+    return;
+
+  // Coalesce all queued commands and the read-back into a single write
+  uint8_t burst[MAX_COMMAND_BURST];
+  uint8_t size = 0;
+
+  for (uint8_t i = 0; i < this->command_queue_count_; i++) {
+    PendingCommand &command = this->command_queue_[i];
+    SpeedAngleSenseCommand::Params params = {command.params[0], command.params[1], command.params[2]};
+
+    switch (command.id) {
+      case CMD_SET_SPEED_ANGLE_SENSE:
+        size += append_command(burst + size, SpeedAngleSenseCommand::encode(params));
+        break;
+      case CMD_SET_MODE_RATE_UOM:
+        size += append_command(burst + size, ModeRateUomCommand::encode(params));
+        break;
+      case CMD_SET_ANTI_VIB_COMP:
+        size += append_command(burst + size, AntiVibCompCommand::encode(params));
+        break;
+      case CMD_SET_RELAY_DURATION_SPEED:
+        size += append_command(burst + size, RelayDurationSpeedCommand::encode(params));
+        break;
+      default:
+        break;
+    }
+
+    if (command.attempts == 0)
+      command.first_sent = now;
+  }
+
+  size += append_command(burst + size, CMD_GET_CONFIG_BYTES);
+  this->update_config_ = false;
+  this->command_awaiting_readback_ = true;
+  this->command_sent_ = now;
+  this->config_writes_++;
+
+  // Measure the speed frames missed around this write when traffic is flowing
+  this->reconfig_measure_pending_ = this->vehicle_tracker_.any_open();
+  this->reconfig_frame_us_ = this->last_frame_us_.load(std::memory_order_relaxed);
+
+  this->issue_command_(burst, size);
+}
+
+void LD2415HComponent::verify_commands_(const uint8_t config[], uint16_t mask) {
+  if (!this->command_awaiting_readback_)
+    return;
+
+  this->command_awaiting_readback_ = false;
+  uint32_t now = millis();
+  uint8_t remaining = 0;
+
+  for (uint8_t i = 0; i < this->command_queue_count_; i++) {
+    PendingCommand &command = this->command_queue_[i];
+
+    if (this->readback_matches_(command.id, command.params, config, mask)) {
+      this->command_latency_ = now - command.first_sent;
+      ESP_LOGD(TAG, "Command 0x%02x confirmed after %u ms", command.id, this->command_latency_);
+    } else {
+      this->command_queue_[remaining++] = command;
+    }
+  }
+
+  this->command_queue_count_ = remaining;
+  if (remaining > 0)
+    this->retry_commands_();
+}
+
+bool LD2415HComponent::readback_matches_(CommandId id, const uint8_t params[3], const uint8_t config[],
+                                         uint16_t mask) {
+  for (uint8_t param = 0; param < 3; param++) {
+    uint8_t key = readback_key(id, param);
+    if (key == READBACK_NONE)
+      continue;
+    if (!(mask & (1 << key)) || config[key] != params[param])
+      return false;
+  }
+  return true;
+}
+
+void LD2415HComponent::reconcile_config_(const uint8_t config[], uint16_t mask) {
+  this->config_reconcile_pending_ = false;
+
+  for (CommandId id : SET_COMMANDS) {
+    uint8_t params[3];
+    this->command_params_(id, params);
+    if (!this->readback_matches_(id, params, config, mask)) {
+      ESP_LOGD(TAG, "Sensor differs from the cached configuration, sending 0x%02x", id);
+      this->queue_command_(id);
+    }
+  }
+}
+
+static uint32_t config_cache_hash(const ConfigCache &cache) {
+  // Over the parameters and then the mask, low byte first
+  const uint8_t mask[2] = {static_cast<uint8_t>(cache.mask & 0xFF), static_cast<uint8_t>(cache.mask >> 8)};
+  return fnv1a_hash(mask, sizeof(mask), fnv1a_hash(cache.config, sizeof(cache.config)));
+}
+
+bool LD2415HComponent::load_config_cache_() {
+  if (!this->config_cache_enabled_)
+    return false;
+
+  this->config_cache_pref_ = global_preferences->make_preference<ConfigCache>(this->config_cache_key_, true);
+  if (!this->config_cache_pref_.load(&this->config_cache_)) {
+    ESP_LOGD(TAG, "No cached configuration, sending full configuration");
+    return false;
+  }
+  if (this->config_cache_.hash != config_cache_hash(this->config_cache_)) {
+    ESP_LOGW(TAG, "Cached configuration invalid, sending full configuration");
+    return false;
+  }
+
+  this->config_cache_valid_ = true;
+  return true;
+}
+
+void LD2415HComponent::save_config_cache_(const uint8_t config[], uint16_t mask) {
+  // The governor moves the sample rate with traffic, so caching it would write
+  // flash on every switch. Left out, the rate command is simply sent at boot.
+  if (this->governor_enabled_)
+    mask &= ~(1 << readback_key(CMD_SET_MODE_RATE_UOM, 1));
+
+  ConfigCache cache{};
+  for (uint8_t key = 0; key < CONFIG_PARAM_COUNT; key++)
+    cache.config[key] = (mask & (1 << key)) ? config[key] : 0;
+  cache.mask = mask;
+  cache.hash = config_cache_hash(cache);
+
+  // Only write flash when the sensor configuration changed
+  if (this->config_cache_valid_ && cache.hash == this->config_cache_.hash && cache.mask == this->config_cache_.mask &&
+      std::memcmp(cache.config, this->config_cache_.config, CONFIG_PARAM_COUNT) == 0)
+    return;
+
+  this->config_cache_ = cache;
+  this->config_cache_valid_ = this->config_cache_pref_.save(&this->config_cache_);
+  ESP_LOGD(TAG, "Configuration cached");
+}
+
+void LD2415HComponent::retry_commands_() {
+  uint8_t remaining = 0;
+  uint8_t attempts = 0;
+
+  for (uint8_t i = 0; i < this->command_queue_count_; i++) {
+    PendingCommand &command = this->command_queue_[i];
+    command.attempts++;
+
+    if (command.attempts >= COMMAND_MAX_ATTEMPTS) {
+      ESP_LOGW(TAG, "Command 0x%02x not accepted after %u attempts", command.id, command.attempts);
+      this->command_failures_++;
+      continue;
+    }
+
+    this->command_retries_++;
+    if (command.attempts > attempts)
+      attempts = command.attempts;
+    this->command_queue_[remaining++] = command;
+  }
+
+  this->command_queue_count_ = remaining;
+
+  // The boot read-back that checks the cached configuration is retried like a
+  // command; if it never arrives the sensor cannot be trusted to match the
+  // cache, so every setting is sent as without one
+  if (this->config_reconcile_pending_) {
+    this->config_reconcile_attempts_++;
+    if (this->config_reconcile_attempts_ < COMMAND_MAX_ATTEMPTS) {
+      this->update_config_ = true;
+      this->command_retries_++;
+      if (this->config_reconcile_attempts_ > attempts)
+        attempts = this->config_reconcile_attempts_;
+    } else {
+      ESP_LOGW(TAG, "No configuration read-back after %u attempts, sending full configuration",
+               this->config_reconcile_attempts_);
+      this->config_reconcile_pending_ = false;
+      for (CommandId id : SET_COMMANDS)
+        this->queue_command_(id);
+    }
+  }
+
+  this->command_backoff_start_ = millis();
+  this->command_backoff_ = COMMAND_BACKOFF << attempts;
+}
+
+size_t LD2415HComponent::read_uart_() {
+  uint8_t buffer[UART_READ_CHUNK];
+  size_t total = 0;
+  int available;
+
+  while ((available = this->available()) > 0) {
+    size_t len = std::min<size_t>(available, sizeof(buffer));
+    if (!this->read_array(buffer, len))
+      break;
+    // Frames are timed from when their bytes left the UART, not from when they
+    // were decoded, so the latency figures include the decoding of the chunk
+    this->chunk_read_us_ = micros();
+    this->feed_(buffer, len);
+    total += len;
+  }
+
+  if (this->speed_trigger_.is_configured())
+    this->speed_trigger_.check_hold(micros());
+
+  return total;
+}
+
+void LD2415HComponent::feed_(const uint8_t *data, size_t len) {
+#ifdef USE_LD2415H_PROFILING
+  // Filling is charged once per chunk, pausing the clock while a completed
+  // frame is handed on, so the cycle counter is read per frame and not per byte
+  uint32_t fill_cycles = 0;
+  uint32_t fill_start = arch_get_cpu_cycle_count();
+#endif
+  for (size_t i = 0; i < len; i++) {
+    if (!this->fill_buffer_(data[i]))
+      continue;
+#ifdef USE_LD2415H_PROFILING
+    fill_cycles += arch_get_cpu_cycle_count() - fill_start;
 #endif
 
-void LD2415HComponent::issue_command_(const uint8_t cmd[], uint8_t size) {
-  for (uint8_t i = 0; i < size; i++)
-    ESP_LOGD(TAG, "  0x%02x", cmd[i]);
+#ifdef USE_ESP32
+    if (this->reader_task_running_) {
+      this->queue_frame_();
+    } else {
+      this->parse_buffer_();
+    }
+#else
+    this->parse_buffer_();
+#endif
+#ifdef USE_LD2415H_PROFILING
+    fill_start = arch_get_cpu_cycle_count();
+#endif
+  }
+#ifdef USE_LD2415H_PROFILING
+  this->profile_[PROFILE_FILL].add(fill_cycles + (arch_get_cpu_cycle_count() - fill_start));
+#endif
+}
 
-  // Don't assume the response buffer is empty, clear it before issuing a command.
-  clear_remaining_buffer_(0);
+void LD2415HComponent::issue_command_(const uint8_t cmd[], uint8_t size) {
+  ESP_LOGD(TAG, "Command: %s", format_hex_pretty(cmd, size).c_str());
   this->write_array(cmd, size);
 }
 
-bool LD2415HComponent::fill_buffer_(char c) {
+bool LD2415HComponent::fill_buffer_(uint8_t c) {
+  if (this->negotiation_mode_.load(std::memory_order_relaxed) == NegotiationMode::STANDARD_PROTOCOL &&
+      (this->in_frame_ || c == FRAME_START))
+    return this->fill_frame_(c);
+
   switch (c) {
     case 0x00:
     case 0xFF:
@@ -194,16 +657,35 @@ bool LD2415HComponent::fill_buffer_(char c) {
       break;
 
     case '\n':
-      // End of response
+      // End of response, the next byte starts a new line. The line is over
+      // even when nothing was kept of it, so commands may be sent again.
+      this->resync_ = false;
+      this->receiving_ = false;
       if (this->response_buffer_index_ == 0)
         break;
 
-      clear_remaining_buffer_(this->response_buffer_index_);
-      ESP_LOGV(TAG, "Response Received:: %s", this->response_buffer_);
+      this->response_buffer_[this->response_buffer_index_] = 0x00;
+      this->frame_end_us_.store(this->chunk_read_us_, std::memory_order_relaxed);
+      LD2415H_LOG_FRAME("Response Received:: %s", this->response_buffer_);
       return true;
 
     default:
+      if (this->resync_) {
+        if (c != 'V' && c != 'X' && c != 'N')
+          break;
+        this->resync_ = false;
+      }
+
+      if (this->response_buffer_index_ >= sizeof(this->response_buffer_) - 1) {
+        // The terminator was lost, drop the line and wait for the next frame
+        this->buffer_overrun_();
+        this->resync_ = true;
+        break;
+      }
+
       // Append to response
+      this->receiving_ = true;
+      this->decode_byte_(c);
       this->response_buffer_[this->response_buffer_index_] = c;
       this->response_buffer_index_++;
       break;
@@ -212,190 +694,663 @@ bool LD2415HComponent::fill_buffer_(char c) {
   return false;
 }
 
-void LD2415HComponent::clear_remaining_buffer_(uint8_t pos) {
-  while (pos < sizeof(this->response_buffer_)) {
-    this->response_buffer_[pos] = 0x00;
-    pos++;
+bool LD2415HComponent::fill_frame_(uint8_t c) {
+  switch (c) {
+    case FRAME_START:
+      // Start of a framed payload, discarding any partial line
+      this->in_frame_ = true;
+      this->receiving_ = true;
+      this->response_buffer_index_ = 0;
+      break;
+
+    case FRAME_END:
+      this->in_frame_ = false;
+      this->receiving_ = false;
+      if (this->response_buffer_index_ == 0)
+        break;
+
+      this->response_buffer_[this->response_buffer_index_] = 0x00;
+      this->frame_end_us_.store(this->chunk_read_us_, std::memory_order_relaxed);
+      this->framed_payloads_++;
+
+      // The payload format is undocumented beyond the ASCII frames, so other
+      // payloads are counted and logged for analysis rather than dispatched
+      if (this->frame_type_ == FrameType::FRAME_UNKNOWN) {
+        this->unknown_payloads_++;
+        LD2415H_LOG_FRAME("Unknown payload: %s",
+                          format_hex_pretty(reinterpret_cast<const uint8_t *>(this->response_buffer_),
+                                            this->response_buffer_index_)
+                              .c_str());
+        this->response_buffer_index_ = 0;
+        this->frame_type_ = FrameType::FRAME_NONE;
+        break;
+      }
+      return true;
+
+    case '\r':
+    case '\n':
+      // ASCII payloads may still carry a line ending
+      break;
+
+    default:
+      if (this->response_buffer_index_ >= sizeof(this->response_buffer_) - 1) {
+        // Too long for any known payload, drop the rest of the frame
+        if (this->frame_type_ != FrameType::FRAME_UNKNOWN)
+          this->buffer_overrun_();
+        this->frame_type_ = FrameType::FRAME_UNKNOWN;
+        break;
+      }
+      this->decode_byte_(c);
+      this->response_buffer_[this->response_buffer_index_] = c;
+      this->response_buffer_index_++;
+      break;
   }
 
+  return false;
+}
+
+void LD2415HComponent::buffer_overrun_() {
+  this->buffer_overruns_++;
+  if (this->error_log_allowed_())
+    ESP_LOGE(TAG, "Response buffer overrun, resynchronizing");
+
   this->response_buffer_index_ = 0;
+  this->frame_type_ = FrameType::FRAME_NONE;
+  // Nothing is kept until the next frame start, so the line counts as idle
+  this->receiving_ = false;
+}
+
+void LD2415HComponent::unknown_frame_() {
+  this->unknown_frames_++;
+  if (this->error_log_allowed_())
+    ESP_LOGE(TAG, "Unknown Response: %s", this->response_buffer_);
+}
+
+bool LD2415HComponent::error_log_allowed_() {
+  // Line noise can produce an error per frame, so log at most one per interval.
+  // Both the reader task and loop() report errors, so the interval is claimed
+  // with a compare-and-swap and only one of them logs.
+  uint32_t now = millis();
+  uint32_t last = this->error_log_time_.load(std::memory_order_relaxed);
+  if (now - last < ERROR_LOG_INTERVAL || !this->error_log_time_.compare_exchange_strong(last, now)) {
+    this->errors_suppressed_++;
+    return false;
+  }
+
+  uint32_t suppressed = this->errors_suppressed_.exchange(0);
+  if (suppressed > 0)
+    ESP_LOGW(TAG, "%u similar errors suppressed", suppressed);
+  return true;
+}
+
+static inline bool is_digit(uint8_t c) { return c >= '0' && c <= '9'; }
+
+static inline int8_t hex_value(uint8_t c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+void LD2415HComponent::decode_byte_(uint8_t c) {
+  // First byte of a frame determines how the remainder is decoded
+  if (this->response_buffer_index_ == 0) {
+    this->frame_negative_ = false;
+    this->frame_digits_ = 0;
+    this->frame_speed_ = 0;
+    this->frame_config_mask_ = 0;
+
+    switch (c) {
+      case 'V':
+        this->frame_type_ = FrameType::FRAME_SPEED;
+        this->parse_state_ = ParseState::PARSE_SPEED_SIGN;
+        break;
+      case 'X':
+        this->frame_type_ = FrameType::FRAME_CONFIG;
+        this->parse_state_ = ParseState::PARSE_CONFIG_KEY;
+        break;
+      case 'N':
+        this->frame_type_ = FrameType::FRAME_FIRMWARE;
+        this->parse_state_ = ParseState::PARSE_PASSTHROUGH;
+        break;
+      default:
+        this->frame_type_ = FrameType::FRAME_UNKNOWN;
+        this->parse_state_ = ParseState::PARSE_PASSTHROUGH;
+        break;
+    }
+    return;
+  }
+
+  switch (this->parse_state_) {
+    case ParseState::PARSE_SPEED_SIGN:
+      if (c == '+' || c == '-') {
+        this->frame_negative_ = (c == '-');
+        this->parse_state_ = ParseState::PARSE_SPEED_INT;
+        return;
+      }
+      break;
+
+    case ParseState::PARSE_SPEED_INT:
+      // Up to three integer digits keeps the tenths value within int16_t
+      if (is_digit(c) && this->frame_digits_ < 3) {
+        this->frame_speed_ = this->frame_speed_ * 10 + (c - '0');
+        this->frame_digits_++;
+        return;
+      }
+      if (c == '.' && this->frame_digits_ > 0) {
+        this->parse_state_ = ParseState::PARSE_SPEED_FRAC;
+        return;
+      }
+      break;
+
+    case ParseState::PARSE_SPEED_FRAC:
+      if (is_digit(c)) {
+        this->frame_speed_ = this->frame_speed_ * 10 + (c - '0');
+        this->parse_state_ = ParseState::PARSE_SPEED_DONE;
+        return;
+      }
+      break;
+
+    case ParseState::PARSE_CONFIG_X:
+      if (c == 'X') {
+        this->parse_state_ = ParseState::PARSE_CONFIG_KEY;
+        return;
+      }
+      break;
+
+    case ParseState::PARSE_CONFIG_KEY:
+      if (is_digit(c)) {
+        this->frame_key_ = c - '0';
+        this->parse_state_ = ParseState::PARSE_CONFIG_COLON;
+        return;
+      }
+      break;
+
+    case ParseState::PARSE_CONFIG_COLON:
+      if (c == ':') {
+        this->parse_state_ = ParseState::PARSE_CONFIG_HI;
+        return;
+      }
+      break;
+
+    case ParseState::PARSE_CONFIG_HI:
+      if (hex_value(c) >= 0) {
+        this->frame_value_ = hex_value(c) << 4;
+        this->parse_state_ = ParseState::PARSE_CONFIG_LO;
+        return;
+      }
+      break;
+
+    case ParseState::PARSE_CONFIG_LO:
+      if (hex_value(c) >= 0) {
+        this->frame_config_[this->frame_key_] = this->frame_value_ | hex_value(c);
+        this->frame_config_mask_ |= 1 << this->frame_key_;
+        this->parse_state_ = ParseState::PARSE_CONFIG_SEP;
+        return;
+      }
+      break;
+
+    case ParseState::PARSE_CONFIG_SEP:
+      if (c == ' ') {
+        this->parse_state_ = ParseState::PARSE_CONFIG_X;
+        return;
+      }
+      break;
+
+    case ParseState::PARSE_PASSTHROUGH:
+      return;
+
+    default:
+      break;
+  }
+
+  // Any byte not accepted above invalidates the frame
+  this->parse_state_ = ParseState::PARSE_INVALID;
 }
 
 void LD2415HComponent::parse_buffer_() {
-  char c = this->response_buffer_[0];
+  Sample sample;
 
-  switch (c) {
-    case 'N':
+  switch (this->frame_type_) {
+    case FrameType::FRAME_FIRMWARE:
       // Firmware Version
-      this->parse_firmware_();
+      this->parse_firmware_(this->response_buffer_);
       break;
-    case 'X':
+    case FrameType::FRAME_CONFIG:
       // Config Response
-      this->parse_config_();
+      this->parse_config_(this->parse_state_ == ParseState::PARSE_CONFIG_SEP, this->frame_config_,
+                          this->frame_config_mask_);
       break;
-    case 'V':
+    case FrameType::FRAME_SPEED:
       // Speed
-      this->parse_speed_();
+      if (this->parse_speed_(sample)) {
+        this->evaluate_speed_trigger_(sample);
+        this->process_sample_(sample);
+      }
       break;
 
     default:
-      ESP_LOGE(TAG, "Unknown Response: %s", this->response_buffer_);
+      this->unknown_frame_();
       break;
   }
+
+  this->response_buffer_index_ = 0;
+  this->frame_type_ = FrameType::FRAME_NONE;
 }
 
-void LD2415HComponent::parse_config_() {
+void LD2415HComponent::parse_config_(bool valid, const uint8_t config[], uint16_t mask) {
   // Example: "X1:01 X2:00 X3:05 X4:01 X5:00 X6:00 X7:05 X8:03 X9:01 X0:01"
+  LD2415H_PROFILE(this->profile_[PROFILE_CONFIG]);
 
-  const char *delim = ": ";
-  uint8_t token_len = 2;
-  char *key;
-  char *val;
+  if (!valid) {
+    this->parse_failures_++;
+    if (this->error_log_allowed_())
+      ESP_LOGE(TAG, "Configuration invalid.");
+    return;
+  }
 
-  char *token = strtok(this->response_buffer_, delim);
+  this->verify_commands_(config, mask);
+  if (this->config_reconcile_pending_)
+    this->reconcile_config_(config, mask);
 
-  while (token != nullptr) {
-    if (std::strlen(token) != token_len) {
-      ESP_LOGE(TAG, "Configuration key length invalid.");
-      break;
-    }
-    key = token;
+  if (this->config_cache_enabled_)
+    this->save_config_cache_(config, mask);
 
-    token = strtok(nullptr, delim);
-    if (std::strlen(token) != token_len) {
-      ESP_LOGE(TAG, "Configuration value length invalid.");
-      break;
-    }
-    val = token;
+  if (!this->configured_ && this->command_queue_count_ == 0) {
+    this->configured_ = true;
+    this->configured_time_ = millis() - this->boot_time_;
+    ESP_LOGI(TAG, "Configured %u ms after setup", this->configured_time_);
+  }
 
-    this->parse_config_param_(key, val);
+  // Report only the parameters that changed since the last read-back
+  uint8_t changed = 0;
+  for (uint8_t key = 0; key < CONFIG_PARAM_COUNT; key++) {
+    if (!(mask & (1 << key)))
+      continue;
 
-    token = strtok(nullptr, delim);
+    if (!(this->reported_config_mask_ & (1 << key)) || this->reported_config_[key] != config[key]) {
+      ESP_LOGD(TAG, "%s (X%u): %u", CONFIG_PARAM_NAMES[key], key, config[key]);
+      changed++;
+    }
+    this->reported_config_[key] = config[key];
+    this->parse_config_param_(key, config[key]);
   }
+  this->reported_config_mask_ |= mask;
 
-  ESP_LOGD(TAG, "Configuration received:");
-  dump_config();
+  if (changed == 0)
+    ESP_LOGV(TAG, "Configuration unchanged");
 }
 
-void LD2415HComponent::parse_firmware_() {
+void LD2415HComponent::parse_firmware_(const char *response) {
   // Example: "No.:20230801E v5.0"
 
-  const char *fw = strchr(this->response_buffer_, ':');
+  const char *fw = strchr(response, ':');
 
   if (fw != nullptr) {
     // Move p to the character after ':'
     ++fw;
 
     // Copy string into firmware
-    std::strncpy(this->firmware_, fw, sizeof(this->firmware_));
+    if (std::strncmp(this->firmware_, fw, sizeof(this->firmware_) - 1) != 0) {
+      std::strncpy(this->firmware_, fw, sizeof(this->firmware_) - 1);
+      ESP_LOGD(TAG, "Firmware: %s", this->firmware_);
+    }
   } else {
-    ESP_LOGE(TAG, "Firmware value invalid.");
+    this->parse_failures_++;
+    if (this->error_log_allowed_())
+      ESP_LOGE(TAG, "Firmware value invalid.");
   }
 }
 
-void LD2415HComponent::parse_speed_() {
+bool LD2415HComponent::parse_speed_(Sample &sample) {
   // Example: "V+001.9"
+  LD2415H_PROFILE(this->profile_[PROFILE_DECODE]);
 
-  const char *p = strchr(this->response_buffer_, 'V');
+  if (this->parse_state_ != ParseState::PARSE_SPEED_DONE) {
+    this->parse_failures_++;
+    if (this->error_log_allowed_())
+      ESP_LOGE(TAG, "Speed value invalid: %s", this->response_buffer_);
+    return false;
+  }
 
-  if (p != nullptr) {
-    ++p;
-    this->velocity_ = strtod(p, nullptr);
-    ++p;
-    this->speed_ = strtod(p, nullptr);
-    
+  sample.speed = this->frame_speed_;
+  sample.velocity = this->frame_negative_ ? -this->frame_speed_ : this->frame_speed_;
+  sample.timestamp = millis();
+  sample.timestamp_us = this->frame_end_us_.load(std::memory_order_relaxed);
+  if (sample.speed == 0) {
+    sample.direction = Direction::DIRECTION_NONE;
+  } else {
+    sample.direction = this->frame_negative_ ? Direction::DIRECTION_RETREATING : Direction::DIRECTION_APPROACHING;
+  }
 
-    ESP_LOGV(TAG, "Speed updated: %f KPH", this->speed_);
+  return true;
+}
 
-    for (auto &listener : this->listeners_) {
-      listener->on_speed(this->speed_);
-      listener->on_velocity(this->velocity_);
-    }
+void LD2415HComponent::evaluate_speed_trigger_(const Sample &sample) {
+  // Runs on the decoding task before the sample is queued or published, so
+  // the pin does not wait for loop() or the sensor filters
+  if (!this->speed_trigger_.is_configured() || !this->speed_trigger_.add(sample))
+    return;
 
-    if (this->speed_sensor_ != nullptr)
-      this->speed_sensor_->publish_state(this->speed_);
+  uint32_t latency = micros() - sample.timestamp_us;
+  this->trigger_activations_++;
+  this->trigger_latency_last_ = latency;
+  if (latency > this->trigger_latency_max_)
+    this->trigger_latency_max_ = latency;
+}
 
-    if (this->velocity_sensor_ != nullptr)
-      this->velocity_sensor_->publish_state(this->velocity_);
+void LD2415HComponent::measure_reconfig_loss_(const Sample &sample) {
+  this->reconfig_measure_pending_ = false;
 
-  } else {
-    ESP_LOGE(TAG, "Speed value invalid.");
+  // A gap as long as the event gap means the vehicle left, not lost frames
+  uint32_t gap = sample.timestamp_us - this->reconfig_frame_us_;
+  if (gap >= this->event_gap_ * 1000)
+    return;
+
+  uint32_t period = SAMPLE_RATE_PERIOD_US[std::min<uint8_t>(this->sample_rate_, SAMPLE_RATE_COUNT - 1)];
+  uint32_t lost = (gap + period / 2) / period;
+  if (lost > 1) {
+    this->reconfig_lost_frames_ += lost - 1;
+    ESP_LOGD(TAG, "Configuration write interrupted ~%u frames", lost - 1);
+  }
+}
+
+void LD2415HComponent::process_sample_(const Sample &sample) {
+  // Intervals across a gap between vehicles are not jitter
+  uint32_t interval = sample.timestamp_us - this->last_frame_us_.load(std::memory_order_relaxed);
+  if (this->first_sample_received_ && interval < this->event_gap_ * 1000)
+    this->frame_interval_.add(interval);
+  this->last_frame_us_.store(sample.timestamp_us, std::memory_order_relaxed);
+
+  if (!this->first_sample_received_) {
+    this->first_sample_received_ = true;
+    this->first_sample_time_ = sample.timestamp - this->boot_time_;
+    ESP_LOGI(TAG, "First sample %u ms after setup", this->first_sample_time_);
   }
+
+  if (this->reconfig_measure_pending_)
+    this->measure_reconfig_loss_(sample);
+
+  this->speed_ = sample.speed;
+  this->velocity_ = sample.velocity;
+
+  LD2415H_LOG_FRAME("Speed updated: %d.%d", this->speed_ / 10, this->speed_ % 10);
+  if (this->frame_summary_interval_ > 0)
+    this->log_frame_summary_(sample);
+
+  {
+    LD2415H_PROFILE(this->profile_[PROFILE_DISPATCH]);
+    for (auto &listener : this->listeners_)
+      listener->on_sample(sample);
+  }
+  this->publish_latency_.add(micros() - sample.timestamp_us);
+
+  if (this->batch_ != nullptr) {
+    this->batch_[this->batch_count_++] = sample;
+    if (this->batch_count_ >= this->batch_size_)
+      this->flush_batch_();
+  }
+
+  this->update_vehicle_event_(sample);
+
+  if (this->governor_enabled_ && this->governor_.add(sample))
+    this->apply_governor_rate_();
+}
+
+void LD2415HComponent::log_frame_summary_(const Sample &sample) {
+  if (this->frame_summary_count_ == 0 || sample.speed < this->frame_summary_min_)
+    this->frame_summary_min_ = sample.speed;
+  if (this->frame_summary_count_ == 0 || sample.speed > this->frame_summary_max_)
+    this->frame_summary_max_ = sample.speed;
+
+  if (++this->frame_summary_count_ < this->frame_summary_interval_)
+    return;
+
+  ESP_LOGD(TAG, "%u frames, speed %d.%d to %d.%d", this->frame_summary_count_, this->frame_summary_min_ / 10,
+           this->frame_summary_min_ % 10, this->frame_summary_max_ / 10, this->frame_summary_max_ % 10);
+  this->frame_summary_count_ = 0;
+}
+
+void LD2415HComponent::update_vehicle_event_(const Sample &sample) {
+  if (sample.speed == 0)
+    return;
+
+  this->vehicle_tracker_.add(sample, [this](const VehicleEvent &event) { this->close_vehicle_event_(event); });
+}
+
+void LD2415HComponent::close_vehicle_event_(const VehicleEvent &event) {
+  ESP_LOGD(TAG, "Vehicle: track %u%s, max %d.%d, mean %d.%d, %u ms, %u frames", event.track,
+           event.overlapped ? " (overlapped)" : "", event.max_speed / 10, event.max_speed % 10, event.mean_speed / 10,
+           event.mean_speed % 10, event.duration, event.frame_count);
+
+  for (auto &listener : this->listeners_)
+    listener->on_vehicle_event(event);
+
+  this->vehicle_event_callback_.call(event);
+}
+
+void LD2415HComponent::update_governor_(uint32_t now) {
+  // Time at each rate is tracked with or without the governor
+  this->governor_.account(this->sample_rate_, now);
+
+  if (this->governor_enabled_ && this->governor_.check_idle(now))
+    this->apply_governor_rate_();
 }
 
-void LD2415HComponent::parse_config_param_(char *key, char *value) {
-  if (std::strlen(key) != 2 || std::strlen(value) != 2 || key[0] != 'X') {
-    ESP_LOGE(TAG, "Invalid Parameter %s:%s", key, value);
+void LD2415HComponent::apply_governor_rate_() {
+  uint8_t rate = this->governor_.target();
+  ESP_LOGD(TAG, "Governor: switching to %s", SAMPLE_RATE_NAMES.to_str(rate));
+
+  // Charge the time so far to the outgoing rate before the switch
+  this->governor_.account(this->sample_rate_, millis());
+  this->sample_rate_ = rate;
+  this->queue_command_(CMD_SET_MODE_RATE_UOM);
+
+#ifdef USE_SELECT
+  if (this->sample_rate_selector_ != nullptr)
+    this->sample_rate_selector_->publish_state(SAMPLE_RATE_NAMES.to_str(rate));
+#endif
+}
+
+void LD2415HComponent::flush_batch_() {
+  if (this->batch_count_ == 0)
     return;
+
+  for (auto &listener : this->batch_listeners_)
+    listener->on_samples(this->batch_.get(), this->batch_count_);
+
+  this->batch_count_ = 0;
+}
+
+void LD2415HComponent::publish_diagnostics_() {
+#ifdef USE_SENSOR
+  if (this->dropped_frames_sensor_ != nullptr)
+    this->dropped_frames_sensor_->publish_state(this->dropped_frames_.load());
+  if (this->command_latency_sensor_ != nullptr)
+    this->command_latency_sensor_->publish_state(this->command_latency_);
+  if (this->command_retries_sensor_ != nullptr)
+    this->command_retries_sensor_->publish_state(this->command_retries_);
+  if (this->command_failures_sensor_ != nullptr)
+    this->command_failures_sensor_->publish_state(this->command_failures_);
+  if (this->buffer_overruns_sensor_ != nullptr)
+    this->buffer_overruns_sensor_->publish_state(this->buffer_overruns_.load());
+  if (this->unknown_frames_sensor_ != nullptr)
+    this->unknown_frames_sensor_->publish_state(this->unknown_frames_.load());
+  if (this->parse_failures_sensor_ != nullptr)
+    this->parse_failures_sensor_->publish_state(this->parse_failures_.load());
+  if (this->frame_jitter_sensor_ != nullptr && this->frame_interval_.count() > 1)
+    this->frame_jitter_sensor_->publish_state(this->frame_interval_.stddev() / 1000.0f);
+  if (this->publish_latency_sensor_ != nullptr && this->publish_latency_.count() > 0)
+    this->publish_latency_sensor_->publish_state(this->publish_latency_.mean() / 1000.0f);
+  if (this->loop_drain_time_sensor_ != nullptr && this->loop_drain_.count() > 0)
+    this->loop_drain_time_sensor_->publish_state(this->loop_drain_.max() / 1000.0f);
+  if (this->config_writes_sensor_ != nullptr)
+    this->config_writes_sensor_->publish_state(this->config_writes_);
+  if (this->reconfig_lost_frames_sensor_ != nullptr)
+    this->reconfig_lost_frames_sensor_->publish_state(this->reconfig_lost_frames_);
+  if (this->trigger_activations_sensor_ != nullptr)
+    this->trigger_activations_sensor_->publish_state(this->trigger_activations_.load());
+  if (this->trigger_latency_sensor_ != nullptr && this->trigger_latency_max_ > 0)
+    this->trigger_latency_sensor_->publish_state(this->trigger_latency_max_ / 1000.0f);
+  for (uint8_t rate = 0; rate < SAMPLE_RATE_COUNT; rate++) {
+    if (this->sample_rate_time_sensors_[rate] != nullptr)
+      this->sample_rate_time_sensors_[rate]->publish_state(this->governor_.time_at(rate) / 1000.0f);
   }
+#endif
+
+#ifdef USE_LD2415H_PROFILING
+  this->log_profile_();
+#endif
 
-  uint8_t v = std::stoi(value, nullptr, 16);
+  // Timing metrics cover one diagnostics interval
+  this->frame_interval_.reset();
+  this->publish_latency_.reset();
+  this->loop_drain_.reset();
+  this->trigger_latency_max_ = 0;
+}
 
-  switch (key[1]) {
-    case '1':
+#ifdef USE_LD2415H_PROFILING
+void LD2415HComponent::log_profile_() {
+  // One JSON object per diagnostics interval, for collection from the log
+  char buffer[384];
+  size_t pos = snprintf(buffer, sizeof(buffer), "{\"interval_ms\":%u", this->diagnostics_interval_);
+  float ns_per_cycle = 1e9f / arch_get_cpu_freq_hz();
+
+  for (uint8_t path = 0; path < PROFILE_COUNT && pos < sizeof(buffer); path++) {
+    ProfileSnapshot current = this->profile_[path].snapshot();
+    ProfileSnapshot &reported = this->profile_reported_[path];
+    uint32_t count = current.count - reported.count;
+    uint32_t cycles = current.cycles - reported.cycles;
+    reported = current;
+
+    pos += snprintf(buffer + pos, sizeof(buffer) - pos, ",\"%s\":{\"n\":%u,\"ns\":%.0f,\"max_ns\":%.0f}",
+                    PROFILE_PATH_NAMES[path], count, count > 0 ? cycles * ns_per_cycle / count : 0.0f,
+                    current.max * ns_per_cycle);
+  }
+
+#ifdef USE_ESP32
+  // Smallest free stack of the reader task since it started
+  if (this->reader_task_running_ && pos < sizeof(buffer)) {
+    pos += snprintf(buffer + pos, sizeof(buffer) - pos, ",\"reader_stack_free\":%u",
+                    (uint32_t) uxTaskGetStackHighWaterMark(this->reader_task_handle_));
+  }
+#endif
+
+  if (pos < sizeof(buffer))
+    snprintf(buffer + pos, sizeof(buffer) - pos, "}");
+  ESP_LOGI(TAG, "Profile: %s", buffer);
+}
+#endif
+
+#ifdef USE_ESP32
+void LD2415HComponent::reader_task_(void *arg) {
+  LD2415HComponent *component = static_cast<LD2415HComponent *>(arg);
+
+  while (true) {
+    component->read_uart_();
+    // ~5 bytes arrive per 5ms at 9600 baud, well within the UART FIFO. The
+    // speed trigger polls every tick so a frame end is seen within one tick.
+    // Always wait at least one tick: pdMS_TO_TICKS(5) is 0 at a 100 Hz tick
+    // rate, which would spin and starve loop() on the same core.
+    vTaskDelay(component->speed_trigger_.is_configured() ? 1 : std::max<TickType_t>(1, pdMS_TO_TICKS(5)));
+  }
+}
+
+void LD2415HComponent::queue_frame_() {
+  if (this->frame_type_ == FrameType::FRAME_SPEED) {
+    Sample sample;
+    if (this->parse_speed_(sample)) {
+      this->evaluate_speed_trigger_(sample);
+      if (!this->sample_ring_.push(sample))
+        this->dropped_frames_++;
+    }
+  } else if (this->frame_type_ == FrameType::FRAME_UNKNOWN) {
+    this->unknown_frame_();
+  } else {
+    Response response;
+    response.type = this->frame_type_;
+    response.valid = this->parse_state_ == ParseState::PARSE_CONFIG_SEP;
+    response.config_mask = this->frame_config_mask_;
+    std::memcpy(response.config, this->frame_config_, sizeof(response.config));
+    std::memcpy(response.text, this->response_buffer_, sizeof(response.text));
+    if (!this->response_ring_.push(response))
+      this->dropped_frames_++;
+  }
+
+  this->response_buffer_index_ = 0;
+  this->frame_type_ = FrameType::FRAME_NONE;
+}
+#endif
+
+void LD2415HComponent::parse_config_param_(uint8_t key, uint8_t v) {
+  switch (key) {
+    case 1:
       this->min_speed_threshold_ = v;
       #ifdef USE_NUMBER
       if (this->min_speed_threshold_number_ != nullptr)
         this->min_speed_threshold_number_->publish_state(this->min_speed_threshold_);
       #endif
       break;
-    case '2':
-      this->compensation_angle_ = std::stoi(value, nullptr, 16);
+    case 2:
+      this->compensation_angle_ = v;
       #ifdef USE_NUMBER
       if (this->compensation_angle_number_ != nullptr)
         this->compensation_angle_number_->publish_state(this->compensation_angle_);
       #endif
       break;
-    case '3':
-      this->sensitivity_ = std::stoi(value, nullptr, 16);
+    case 3:
+      this->sensitivity_ = v;
       #ifdef USE_NUMBER
       if (this->sensitivity_number_ != nullptr)
         this->sensitivity_number_->publish_state(this->sensitivity_);
       #endif
       break;
-    case '4':
+    case 4:
       this->tracking_mode_ = this->i_to_tracking_mode_(v);
       #ifdef USE_SELECT
       if (this->tracking_mode_selector_ != nullptr)
-        this->tracking_mode_selector_->publish_state(this->i_to_s_(TRACKING_MODE_STR_TO_INT, this->tracking_mode_));
+        this->tracking_mode_selector_->publish_state(TRACKING_MODE_NAMES.to_str(this->tracking_mode_));
       #endif
       break;
-    case '5':
+    case 5:
       this->sample_rate_ = v;
       #ifdef USE_SELECT
       if (this->sample_rate_selector_ != nullptr)
-        this->sample_rate_selector_->publish_state(this->i_to_s_(SAMPLE_RATE_STR_TO_INT, this->sample_rate_));
+        this->sample_rate_selector_->publish_state(SAMPLE_RATE_NAMES.to_str(this->sample_rate_));
       #endif
       break;
-    case '6':
+    case 6:
       this->unit_of_measure_ = this->i_to_unit_of_measure_(v);
       break;
-    case '7':
+    case 7:
       this->vibration_correction_ = v;
       #ifdef USE_NUMBER
       if (this->vibration_correction_number_ != nullptr)
         this->vibration_correction_number_->publish_state(this->vibration_correction_);
       #endif
       break;
-    case '8':
+    case 8:
       this->relay_trigger_duration_ = v;
       #ifdef USE_NUMBER
       if (this->relay_trigger_duration_number_ != nullptr)
         this->relay_trigger_duration_number_->publish_state(this->relay_trigger_duration_);
       #endif
       break;
-    case '9':
+    case 9:
       this->relay_trigger_speed_ = v;
       #ifdef USE_NUMBER
       if (this->relay_trigger_speed_number_ != nullptr)
         this->relay_trigger_speed_number_->publish_state(this->relay_trigger_speed_);
       #endif
       break;
-    case '0':
-      this->negotiation_mode_ = this->i_to_negotiation_mode_(v);
+    case 0:
+      this->negotiation_mode_.store(this->i_to_negotiation_mode_(v), std::memory_order_relaxed);
       break;
     default:
-      ESP_LOGD(TAG, "Unknown Parameter %s:%s", key, value);
+      ESP_LOGD(TAG, "Unknown Parameter X%u:%02x", key, v);
       break;
   }
 }
@@ -444,14 +1399,5 @@ NegotiationMode LD2415HComponent::i_to_negotiation_mode_(uint8_t value) {
   }
 }
 
-const char *LD2415HComponent::i_to_s_(const std::map<std::string, uint8_t> &map, uint8_t i) {
-  for (const auto &pair : map) {
-    if (pair.second == i) {
-      return pair.first.c_str();
-    }
-  }
-  return "Unknown";
-}
-
 }  // namespace ld2415h
 }  // namespace esphome
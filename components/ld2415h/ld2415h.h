@@ -1,15 +1,29 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
 #include "esphome/components/uart/uart.h"
 #include "esphome/components/sensor/sensor.h"
+#include "commands.h"
+#include "enum_table.h"
+#include "profiling.h"
+#include "running_stats.h"
+#include "sample_rate_governor.h"
+#include "speed_trigger.h"
+#include "spsc_ring.h"
+#include "vehicle_event.h"
 #ifdef USE_NUMBER
 #include "esphome/components/number/number.h"
 #endif
 #ifdef USE_SELECT
 #include "esphome/components/select/select.h"
 #endif
-#include <map>
+#include <algorithm>
+#include <memory>
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
 
 namespace esphome {
 namespace ld2415h {
@@ -22,27 +36,109 @@ enum TrackingMode : uint8_t { APPROACHING_AND_RETREATING = 0x00, APPROACHING = 0
 
 enum UnitOfMeasure : uint8_t { KPH = 0x00, MPH = 0x01, MPS = 0x02 };
 
-static const std::map<std::string, uint8_t> NEGOTIATION_MODE_STR_TO_INT{
-    {"Custom Agreement", CUSTOM_AGREEMENT}, {"Standard Protocol", STANDARD_PROTOCOL}};
+enum FrameType : uint8_t { FRAME_NONE, FRAME_SPEED, FRAME_CONFIG, FRAME_FIRMWARE, FRAME_UNKNOWN };
+
+// Position of the incremental parser within the current frame
+enum ParseState : uint8_t {
+  PARSE_INVALID,
+  PARSE_PASSTHROUGH,
+  // "V+001.9"
+  PARSE_SPEED_SIGN,
+  PARSE_SPEED_INT,
+  PARSE_SPEED_FRAC,
+  PARSE_SPEED_DONE,
+  // "X1:01 X2:00 ..."
+  PARSE_CONFIG_X,
+  PARSE_CONFIG_KEY,
+  PARSE_CONFIG_COLON,
+  PARSE_CONFIG_HI,
+  PARSE_CONFIG_LO,
+  PARSE_CONFIG_SEP,
+};
+
+static const uint8_t CONFIG_PARAM_COUNT = 10;
+
+// Code paths measured with the profiling option
+enum ProfilePath : uint8_t { PROFILE_FILL, PROFILE_DECODE, PROFILE_DISPATCH, PROFILE_CONFIG, PROFILE_COUNT };
 
-static const std::map<std::string, uint8_t> SAMPLE_RATE_STR_TO_INT{
-    {"~22 fps", SAMPLE_RATE_22FPS}, {"~11 fps", SAMPLE_RATE_11FPS}, {"~6 fps", SAMPLE_RATE_6FPS}};
+// Per-frame log sites cost a format call for every frame even when the
+// logger drops the message, so they are only compiled in with frame_logging
+#ifdef USE_LD2415H_FRAME_LOGGING
+#define LD2415H_LOG_FRAME(...) ESP_LOGV(TAG, __VA_ARGS__)
+#else
+#define LD2415H_LOG_FRAME(...)
+#endif
+
+static constexpr EnumTable<2> NEGOTIATION_MODE_NAMES{CUSTOM_AGREEMENT, {"Custom Agreement", "Standard Protocol"}};
+
+static constexpr EnumTable<3> SAMPLE_RATE_NAMES{SAMPLE_RATE_22FPS, {"~22 fps", "~11 fps", "~6 fps"}};
 
-static const std::map<std::string, uint8_t> TRACKING_MODE_STR_TO_INT{
-    {"Approaching and Retreating", APPROACHING_AND_RETREATING},
-    {"Approaching", APPROACHING},
-    {"Retreating", RETREATING}};
+static constexpr EnumTable<3> TRACKING_MODE_NAMES{APPROACHING_AND_RETREATING,
+                                                  {"Approaching and Retreating", "Approaching", "Retreating"}};
 
-static const std::map<std::string, uint8_t> UNIT_OF_MEASURE_STR_TO_INT{
-    {"km/h", KPH}, {"mph", MPH}, {"m/s", MPS}};
+static constexpr EnumTable<3> UNIT_OF_MEASURE_NAMES{KPH, {"km/h", "mph", "m/s"}};
 
+static_assert(SAMPLE_RATE_NAMES.size() == SAMPLE_RATE_COUNT, "Sample rate names out of step with the governor");
 
 class LD2415HListener {
  public:
+#ifdef USE_LD2415H_DOUBLE_LISTENER
+  // Forward to the legacy floating point callbacks for existing listeners
+  virtual void on_sample(const Sample &sample) {
+    this->on_speed(sample.speed / 10.0);
+    this->on_velocity(sample.velocity / 10.0);
+  };
   virtual void on_speed(double speed){};
   virtual void on_velocity(double velocity){};
+#else
+  virtual void on_sample(const Sample &sample){};
+#endif
+  // Called with a block of samples when registered as a batch listener
+  virtual void on_samples(const Sample *samples, size_t count){};
+  // Called once per vehicle after frames stop for the configured event gap
+  virtual void on_vehicle_event(const VehicleEvent &event){};
+};
+
+// A non-speed frame handed from the reader task to loop()
+struct Response {
+  FrameType type;
+  bool valid;
+  uint8_t config[CONFIG_PARAM_COUNT];
+  uint16_t config_mask;
+  char text[64];
+};
+
+// A set command waiting to be confirmed by a configuration read-back
+struct PendingCommand {
+  CommandId id;
+  uint8_t params[3];
+  uint8_t attempts;
+  uint32_t first_sent;
+};
+
+// Last confirmed sensor configuration, kept in flash so boot can skip
+// commands that the sensor already holds
+struct ConfigCache {
+  uint8_t config[CONFIG_PARAM_COUNT];
+  uint16_t mask;
+  uint32_t hash;
 };
 
+static const uint8_t COMMAND_QUEUE_SIZE = 5;
+static const uint8_t COMMAND_MAX_ATTEMPTS = 4;
+static const uint32_t COMMAND_TIMEOUT = 1000;
+static const uint32_t COMMAND_BACKOFF = 250;
+// A continuous stream of changes is still sent after this many debounce windows
+static const uint8_t CONFIG_DEBOUNCE_MAX_WINDOWS = 4;
+
+// Nominal speed frame period at each sample rate
+static const uint32_t SAMPLE_RATE_PERIOD_US[] = {1000000 / 22, 1000000 / 11, 1000000 / 6};
+
+static const uint8_t UART_READ_CHUNK = 32;
+static const uint32_t ERROR_LOG_INTERVAL = 1000;
+static const uint16_t SAMPLE_RING_SIZE = 32;
+static const uint16_t RESPONSE_RING_SIZE = 4;
+
 class LD2415HComponent : public Component, public uart::UARTDevice {
  public:
   // Constructor declaration
@@ -66,6 +162,70 @@ class LD2415HComponent : public Component, public uart::UARTDevice {
 
   float get_setup_priority() const override { return setup_priority::HARDWARE; }
   void register_listener(LD2415HListener *listener) { this->listeners_.push_back(listener); }
+  void register_batch_listener(LD2415HListener *listener) { this->batch_listeners_.push_back(listener); }
+  void set_batch_size(uint16_t size) { this->batch_size_ = size; }
+  void set_batch_interval(uint32_t interval) { this->batch_interval_ = interval; }
+  void set_diagnostics_interval(uint32_t interval) { this->diagnostics_interval_ = interval; }
+  void set_frame_summary_interval(uint16_t frames) { this->frame_summary_interval_ = frames; }
+  void set_event_gap(uint32_t gap) {
+    this->event_gap_ = gap;
+    this->vehicle_tracker_.set_gap(gap);
+  }
+  void set_max_tracks(uint8_t tracks) { this->vehicle_tracker_.set_max_tracks(tracks); }
+  void set_track_gate(speed_t gate) { this->vehicle_tracker_.set_gate(gate); }
+  void set_config_debounce(uint32_t debounce) { this->config_debounce_ = debounce; }
+  uint32_t get_event_gap() const { return this->event_gap_; }
+  uint8_t get_compensation_angle() const { return this->compensation_angle_; }
+  uint8_t get_sensitivity() const { return this->sensitivity_; }
+  uint8_t get_vibration_correction() const { return this->vibration_correction_; }
+  // A configuration write is queued or awaiting its read-back
+  bool is_config_pending() const { return this->command_queue_count_ > 0 || this->command_awaiting_readback_; }
+  void set_config_cache(const std::string &id) {
+    this->config_cache_key_ = fnv1_hash("ld2415h_config_" + id);
+    this->config_cache_enabled_ = true;
+  }
+  void set_sample_rate_governor(uint8_t active_rate, uint8_t idle_rate, uint32_t hold_time, uint8_t activation_frames) {
+    this->governor_.set_rates(active_rate, idle_rate);
+    this->governor_.set_hold_time(hold_time);
+    this->governor_.set_activation_frames(activation_frames);
+    this->governor_enabled_ = true;
+  }
+  void set_speed_trigger(InternalGPIOPin *pin, speed_t speed, speed_t hysteresis, Direction direction,
+                         uint32_t hold_time) {
+    this->speed_trigger_.set_pin(pin);
+    this->speed_trigger_.set_speed(speed);
+    this->speed_trigger_.set_hysteresis(hysteresis);
+    this->speed_trigger_.set_direction(direction);
+    this->speed_trigger_.set_hold_time(hold_time);
+  }
+  void add_on_vehicle_event_callback(std::function<void(VehicleEvent)> &&callback) {
+    this->vehicle_event_callback_.add(std::move(callback));
+  }
+#ifdef USE_ESP32
+  void set_reader_task(uint8_t core, uint8_t priority) {
+    this->reader_task_core_ = core;
+    this->reader_task_priority_ = priority;
+  }
+#endif
+#ifdef USE_SENSOR
+  void set_dropped_frames_sensor(sensor::Sensor *sensor) { this->dropped_frames_sensor_ = sensor; }
+  void set_command_latency_sensor(sensor::Sensor *sensor) { this->command_latency_sensor_ = sensor; }
+  void set_command_retries_sensor(sensor::Sensor *sensor) { this->command_retries_sensor_ = sensor; }
+  void set_command_failures_sensor(sensor::Sensor *sensor) { this->command_failures_sensor_ = sensor; }
+  void set_buffer_overruns_sensor(sensor::Sensor *sensor) { this->buffer_overruns_sensor_ = sensor; }
+  void set_unknown_frames_sensor(sensor::Sensor *sensor) { this->unknown_frames_sensor_ = sensor; }
+  void set_parse_failures_sensor(sensor::Sensor *sensor) { this->parse_failures_sensor_ = sensor; }
+  void set_frame_jitter_sensor(sensor::Sensor *sensor) { this->frame_jitter_sensor_ = sensor; }
+  void set_publish_latency_sensor(sensor::Sensor *sensor) { this->publish_latency_sensor_ = sensor; }
+  void set_loop_drain_time_sensor(sensor::Sensor *sensor) { this->loop_drain_time_sensor_ = sensor; }
+  void set_config_writes_sensor(sensor::Sensor *sensor) { this->config_writes_sensor_ = sensor; }
+  void set_reconfig_lost_frames_sensor(sensor::Sensor *sensor) { this->reconfig_lost_frames_sensor_ = sensor; }
+  void set_trigger_activations_sensor(sensor::Sensor *sensor) { this->trigger_activations_sensor_ = sensor; }
+  void set_trigger_latency_sensor(sensor::Sensor *sensor) { this->trigger_latency_sensor_ = sensor; }
+  void set_sample_rate_time_sensor(uint8_t rate, sensor::Sensor *sensor) {
+    this->sample_rate_time_sensors_[rate] = sensor;
+  }
+#endif
 
   void set_min_speed_threshold(uint8_t speed);
   void set_compensation_angle(uint8_t angle);
@@ -78,6 +238,9 @@ class LD2415HComponent : public Component, public uart::UARTDevice {
   void set_vibration_correction(uint8_t correction);
   void set_relay_trigger_duration(uint8_t duration);
   void set_relay_trigger_speed(uint8_t speed);
+  // Changes made between these calls are sent as one write; they nest
+  void begin_config();
+  void end_config();
 
 #ifdef USE_NUMBER
   number::Number *min_speed_threshold_number_{nullptr};
@@ -91,11 +254,25 @@ class LD2415HComponent : public Component, public uart::UARTDevice {
   select::Select *sample_rate_selector_{nullptr};
   select::Select *tracking_mode_selector_{nullptr};
 #endif
+#ifdef USE_SENSOR
+  sensor::Sensor *dropped_frames_sensor_{nullptr};
+  sensor::Sensor *command_latency_sensor_{nullptr};
+  sensor::Sensor *command_retries_sensor_{nullptr};
+  sensor::Sensor *command_failures_sensor_{nullptr};
+  sensor::Sensor *buffer_overruns_sensor_{nullptr};
+  sensor::Sensor *unknown_frames_sensor_{nullptr};
+  sensor::Sensor *parse_failures_sensor_{nullptr};
+  sensor::Sensor *frame_jitter_sensor_{nullptr};
+  sensor::Sensor *publish_latency_sensor_{nullptr};
+  sensor::Sensor *loop_drain_time_sensor_{nullptr};
+  sensor::Sensor *config_writes_sensor_{nullptr};
+  sensor::Sensor *reconfig_lost_frames_sensor_{nullptr};
+  sensor::Sensor *trigger_activations_sensor_{nullptr};
+  sensor::Sensor *trigger_latency_sensor_{nullptr};
+  sensor::Sensor *sample_rate_time_sensors_[SAMPLE_RATE_COUNT]{};
+#endif
 
  protected:
-  sensor::Sensor *speed_sensor_{nullptr};
-  sensor::Sensor *velocity_sensor_{nullptr};
-
   // Configuration
   uint8_t min_speed_threshold_ = 1;
   uint8_t compensation_angle_ = 0;
@@ -106,44 +283,195 @@ class LD2415HComponent : public Component, public uart::UARTDevice {
   uint8_t vibration_correction_ = 18;
   uint8_t relay_trigger_duration_ = 0;
   uint8_t relay_trigger_speed_ = 1;
-  NegotiationMode negotiation_mode_ = NegotiationMode::CUSTOM_AGREEMENT;
+  // Read by the decoding task to select the framing
+  std::atomic<NegotiationMode> negotiation_mode_{NegotiationMode::CUSTOM_AGREEMENT};
 
   // State
-  uint8_t cmd_set_speed_angle_sense_[8] = {0x43, 0x46, 0x01, 0x01, 0x00, 0x05, 0x0d, 0x0a};
-  uint8_t cmd_set_mode_rate_uom_[8] = {0x43, 0x46, 0x02, 0x01, 0x01, 0x00, 0x0d, 0x0a};
-  uint8_t cmd_set_anti_vib_comp_[8] = {0x43, 0x46, 0x03, 0x05, 0x00, 0x00, 0x0d, 0x0a};
-  uint8_t cmd_set_relay_duration_speed_[8] = {0x43, 0x46, 0x04, 0x03, 0x01, 0x00, 0x0d, 0x0a};
-  uint8_t cmd_get_config_[13] = {0x43, 0x46, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-
-  bool update_speed_angle_sense_ = true;
-  bool update_mode_rate_uom_ = true;
-  bool update_anti_vib_comp_ = true;
-  bool update_relay_duration_speed_ = true;
+  // Set commands are queued, sent while the UART is idle, then confirmed by a
+  // configuration read-back and retried with backoff until they match.
+  PendingCommand command_queue_[COMMAND_QUEUE_SIZE];
+  uint8_t command_queue_count_ = 0;
+  bool command_awaiting_readback_ = false;
+  uint32_t command_sent_ = 0;
+  // Retry backoff in progress, 0 when none; elapsed time is compared unsigned
+  // so it holds across the millis() wrap
+  uint32_t command_backoff_ = 0;
+  uint32_t command_backoff_start_ = 0;
+  uint32_t command_latency_ = 0;
+  uint32_t command_retries_ = 0;
+  uint32_t command_failures_ = 0;
   bool update_config_ = false;
 
+  // Debounce and batching of changes from entities and automations
+  uint32_t config_debounce_ = 0;
+  // While a hold is active, commands wait until no change has come for one
+  // debounce window; times are compared as unsigned elapsed time
+  uint32_t config_hold_start_ = 0;
+  uint32_t config_hold_last_ = 0;
+  bool config_hold_started_ = false;
+  uint8_t config_batch_depth_ = 0;
+  uint32_t config_writes_ = 0;
+  uint32_t reconfig_lost_frames_ = 0;
+  uint32_t reconfig_frame_us_ = 0;
+  bool reconfig_measure_pending_ = false;
+
+  // Boot reconciliation against the cached configuration
+  ESPPreferenceObject config_cache_pref_;
+  ConfigCache config_cache_{};
+  uint32_t config_cache_key_ = 0;
+  bool config_cache_enabled_ = false;
+  bool config_cache_valid_ = false;
+  bool config_reconcile_pending_ = false;
+  uint8_t config_reconcile_attempts_ = 0;
+  uint32_t boot_time_ = 0;
+  uint32_t first_sample_time_ = 0;
+  bool first_sample_received_ = false;
+  uint32_t configured_time_ = 0;
+  bool configured_ = false;
+
   char firmware_[20] = "";
-  double speed_ = 0;
-  double velocity_ = 0;
+  speed_t speed_ = 0;
+  speed_t velocity_ = 0;
   char response_buffer_[64];
   uint8_t response_buffer_index_ = 0;
+  std::atomic<bool> receiving_{false};
+
+  // Incremental frame decoding, updated as each byte arrives
+  FrameType frame_type_ = FrameType::FRAME_NONE;
+  ParseState parse_state_ = ParseState::PARSE_INVALID;
+  bool frame_negative_ = false;
+  uint8_t frame_digits_ = 0;
+  int16_t frame_speed_ = 0;  // Tenths of the configured unit of measure
+  uint8_t frame_key_ = 0;
+  uint8_t frame_value_ = 0;
+  uint8_t frame_config_[CONFIG_PARAM_COUNT];
+  uint16_t frame_config_mask_ = 0;
+  // Discarding input after an overrun until the next frame start
+  bool resync_ = false;
+  // Inside a Standard Protocol 0xFA ... 0xFB frame
+  bool in_frame_ = false;
+  std::atomic<uint32_t> framed_payloads_{0};
+  std::atomic<uint32_t> unknown_payloads_{0};
+
+  // Input errors, counted on whichever task decodes the frame
+  std::atomic<uint32_t> buffer_overruns_{0};
+  std::atomic<uint32_t> unknown_frames_{0};
+  std::atomic<uint32_t> parse_failures_{0};
+  std::atomic<uint32_t> error_log_time_{0};
+  std::atomic<uint32_t> errors_suppressed_{0};
 
   // Processing
+  void queue_command_(CommandId id);
+  void stage_command_(CommandId id);
+  void command_params_(CommandId id, uint8_t params[3]);
+  bool readback_matches_(CommandId id, const uint8_t params[3], const uint8_t config[], uint16_t mask);
+  bool load_config_cache_();
+  void save_config_cache_(const uint8_t config[], uint16_t mask);
+  void reconcile_config_(const uint8_t config[], uint16_t mask);
+  void process_commands_();
+  void verify_commands_(const uint8_t config[], uint16_t mask);
+  void retry_commands_();
   void issue_command_(const uint8_t cmd[], uint8_t size);
-  bool fill_buffer_(char c);
-  void clear_remaining_buffer_(uint8_t pos);
+  size_t read_uart_();
+  // Entry point for raw sensor output, independent of the UART
+  void feed_(const uint8_t *data, size_t len);
+  bool fill_buffer_(uint8_t c);
+  bool fill_frame_(uint8_t c);
+  void decode_byte_(uint8_t c);
+  void buffer_overrun_();
+  void unknown_frame_();
+  bool error_log_allowed_();
   void parse_buffer_();
-  void parse_config_();
-  void parse_firmware_();
-  void parse_speed_();
-  void parse_config_param_(char *key, char *value);
+  void parse_config_(bool valid, const uint8_t config[], uint16_t mask);
+  void parse_firmware_(const char *response);
+  bool parse_speed_(Sample &sample);
+  void evaluate_speed_trigger_(const Sample &sample);
+  void measure_reconfig_loss_(const Sample &sample);
+  void process_sample_(const Sample &sample);
+  void log_frame_summary_(const Sample &sample);
+  void flush_batch_();
+  void update_vehicle_event_(const Sample &sample);
+  void close_vehicle_event_(const VehicleEvent &event);
+  void publish_diagnostics_();
+#ifdef USE_LD2415H_PROFILING
+  void log_profile_();
+#endif
+  void update_governor_(uint32_t now);
+  void apply_governor_rate_();
+  void parse_config_param_(uint8_t key, uint8_t value);
 
   // Helpers
   TrackingMode i_to_tracking_mode_(uint8_t value);
   UnitOfMeasure i_to_unit_of_measure_(uint8_t value);
   NegotiationMode i_to_negotiation_mode_(uint8_t value);
-  const char *i_to_s_(const std::map<std::string, uint8_t> &map, uint8_t i);
 
   std::vector<LD2415HListener *> listeners_{};
+  std::vector<LD2415HListener *> batch_listeners_{};
+
+  // Samples held for batch listeners, allocated once in setup()
+  std::unique_ptr<Sample[]> batch_{nullptr};
+  uint16_t batch_size_ = 32;
+  uint16_t batch_count_ = 0;
+  uint32_t batch_interval_ = 0;
+
+  // Vehicle event segmentation
+  VehicleTracker vehicle_tracker_;
+  uint32_t event_gap_ = 500;
+  CallbackManager<void(VehicleEvent)> vehicle_event_callback_;
+
+  // Switches the sample rate with traffic when configured
+  SampleRateGovernor governor_;
+  bool governor_enabled_ = false;
+
+  // Output pin driven from the decoding task, with the time from the end of
+  // the frame to the pin write in microseconds
+  SpeedTrigger speed_trigger_;
+  std::atomic<uint32_t> trigger_activations_{0};
+  std::atomic<uint32_t> trigger_latency_last_{0};
+  std::atomic<uint32_t> trigger_latency_max_{0};
+
+  // Last configuration read-back, so only changes are logged
+  uint8_t reported_config_[CONFIG_PARAM_COUNT];
+  uint16_t reported_config_mask_ = 0;
+
+  // One summary line per frame_summary_interval_ speed frames
+  uint16_t frame_summary_interval_ = 0;
+  uint16_t frame_summary_count_ = 0;
+  speed_t frame_summary_min_ = 0;
+  speed_t frame_summary_max_ = 0;
+
+  // Timing instrumentation in microseconds, reset at each diagnostics interval.
+  // The frame times are written by the decoding task and read by loop().
+  std::atomic<uint32_t> frame_end_us_{0};
+  // micros() when the chunk being decoded was read, only used by the decoding task
+  uint32_t chunk_read_us_{0};
+  std::atomic<uint32_t> last_frame_us_{0};
+  RunningStats frame_interval_;
+  RunningStats publish_latency_;
+  RunningStats loop_drain_;
+
+#ifdef USE_LD2415H_PROFILING
+  // Per byte input, per speed frame decode and listener fan-out, per config read-back
+  ProfileCounter profile_[PROFILE_COUNT];
+  ProfileSnapshot profile_reported_[PROFILE_COUNT]{};
+#endif
+
+  uint32_t diagnostics_interval_ = 60000;
+  std::atomic<uint32_t> dropped_frames_{0};
+
+#ifdef USE_ESP32
+  // Optional FreeRTOS task that owns the UART and parser, handing decoded
+  // frames to loop() through lock-free rings.
+  static void reader_task_(void *arg);
+  void queue_frame_();
+
+  TaskHandle_t reader_task_handle_{nullptr};
+  bool reader_task_running_ = false;
+  int8_t reader_task_core_ = -1;
+  uint8_t reader_task_priority_ = 5;
+  SPSCRing<Sample, SAMPLE_RING_SIZE> sample_ring_;
+  SPSCRing<Response, RESPONSE_RING_SIZE> response_ring_;
+#endif
 };
 
 }  // namespace ld2415h
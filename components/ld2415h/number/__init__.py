@@ -98,7 +98,7 @@ async def to_code(config):
     if sensitivity_config := config.get(CONF_SENSITIVITY):
         num = await number.new_number(
             sensitivity_config,
-            min_value=0,
+            min_value=1,
             max_value=15,
             step=1,
         )
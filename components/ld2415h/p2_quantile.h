@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace ld2415h {
+
+// Streaming quantile estimate using the P-square algorithm (Jain & Chlamtac),
+// which tracks a single quantile with five markers in constant memory.
+class P2Quantile {
+ public:
+  explicit P2Quantile(float quantile = 0.5f) { this->set_quantile(quantile); }
+
+  void set_quantile(float quantile) {
+    this->quantile_ = quantile;
+    this->reset();
+  }
+
+  void reset() {
+    this->count_ = 0;
+    const float p = this->quantile_;
+    const float desired[5] = {0.0f, 2.0f * p, 4.0f * p, 2.0f + 2.0f * p, 4.0f};
+    const float increment[5] = {0.0f, p / 2.0f, p, (1.0f + p) / 2.0f, 1.0f};
+    for (uint8_t i = 0; i < 5; i++) {
+      this->positions_[i] = i;
+      this->desired_[i] = desired[i];
+      this->increment_[i] = increment[i];
+    }
+  }
+
+  void add(float x) {
+    // Collect the first five observations as the initial markers
+    if (this->count_ < 5) {
+      this->heights_[this->count_++] = x;
+      if (this->count_ == 5)
+        std::sort(this->heights_, this->heights_ + 5);
+      return;
+    }
+    this->count_++;
+
+    uint8_t k;
+    if (x < this->heights_[0]) {
+      this->heights_[0] = x;
+      k = 0;
+    } else if (x >= this->heights_[4]) {
+      this->heights_[4] = x;
+      k = 3;
+    } else {
+      k = 0;
+      while (k < 3 && x >= this->heights_[k + 1])
+        k++;
+    }
+
+    for (uint8_t i = k + 1; i < 5; i++)
+      this->positions_[i]++;
+    for (uint8_t i = 0; i < 5; i++)
+      this->desired_[i] += this->increment_[i];
+
+    // Move the middle markers towards their desired positions
+    for (uint8_t i = 1; i < 4; i++) {
+      float d = this->desired_[i] - this->positions_[i];
+      if ((d >= 1.0f && this->positions_[i + 1] - this->positions_[i] > 1) ||
+          (d <= -1.0f && this->positions_[i - 1] - this->positions_[i] < -1)) {
+        int8_t s = d > 0 ? 1 : -1;
+        float q = this->parabolic_(i, s);
+        if (this->heights_[i - 1] < q && q < this->heights_[i + 1]) {
+          this->heights_[i] = q;
+        } else {
+          this->heights_[i] = this->linear_(i, s);
+        }
+        this->positions_[i] += s;
+      }
+    }
+  }
+
+  float value() const {
+    if (this->count_ == 0)
+      return NAN;
+    if (this->count_ >= 5)
+      return this->heights_[2];
+
+    // Exact quantile of the few observations seen so far
+    float sorted[5];
+    std::copy(this->heights_, this->heights_ + this->count_, sorted);
+    std::sort(sorted, sorted + this->count_);
+    uint8_t index = std::lround(this->quantile_ * (this->count_ - 1));
+    return sorted[index];
+  }
+
+  uint32_t count() const { return this->count_; }
+
+ protected:
+  float parabolic_(uint8_t i, int8_t s) const {
+    const float *q = this->heights_;
+    const int32_t *n = this->positions_;
+    return q[i] + s / float(n[i + 1] - n[i - 1]) *
+                      ((n[i] - n[i - 1] + s) * (q[i + 1] - q[i]) / float(n[i + 1] - n[i]) +
+                       (n[i + 1] - n[i] - s) * (q[i] - q[i - 1]) / float(n[i] - n[i - 1]));
+  }
+
+  float linear_(uint8_t i, int8_t s) const {
+    return this->heights_[i] + s * (this->heights_[i + s] - this->heights_[i]) /
+                                   float(this->positions_[i + s] - this->positions_[i]);
+  }
+
+  float quantile_;
+  uint32_t count_{0};
+  float heights_[5];
+  int32_t positions_[5];
+  float desired_[5];
+  float increment_[5];
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
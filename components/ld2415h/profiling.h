@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "esphome/core/hal.h"
+
+namespace esphome {
+namespace ld2415h {
+
+// Totals of a ProfileCounter at one point in time, with the longest run since
+// the previous snapshot
+struct ProfileSnapshot {
+  uint32_t cycles;
+  uint32_t count;
+  uint32_t max;
+};
+
+// CPU cycles spent in one code path. cycles and count are written only by the
+// task that runs the path and never reset, so a reader takes deltas between
+// snapshots; max is cleared by each snapshot so it covers the same interval.
+// The fields are 32-bit atomics so a read from another core is never torn;
+// cycles wraps, which the modular delta absorbs as long as one diagnostics
+// interval spends less than 2^32 cycles (about 17 s at 240 MHz) in the path.
+// A run that ends while a snapshot is taken may be counted in either interval.
+struct ProfileCounter {
+  std::atomic<uint32_t> cycles{0};
+  std::atomic<uint32_t> count{0};
+  std::atomic<uint32_t> max{0};
+
+  void add(uint32_t elapsed) {
+    // Single writer, so plain load/store pairs need no read-modify-write
+    this->cycles.store(this->cycles.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+    this->count.store(this->count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (elapsed > this->max.load(std::memory_order_relaxed))
+      this->max.store(elapsed, std::memory_order_relaxed);
+  }
+
+  ProfileSnapshot snapshot() {
+    return {this->cycles.load(std::memory_order_relaxed), this->count.load(std::memory_order_relaxed),
+            this->max.exchange(0, std::memory_order_relaxed)};
+  }
+};
+
+// Charges the cycles until the end of the enclosing scope to a counter
+class ProfileScope {
+ public:
+  explicit ProfileScope(ProfileCounter &counter) : counter_(counter), start_(arch_get_cpu_cycle_count()) {}
+  ~ProfileScope() { this->counter_.add(arch_get_cpu_cycle_count() - this->start_); }
+
+ protected:
+  ProfileCounter &counter_;
+  uint32_t start_;
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
+
+// Profiling is compiled in only with the profiling option, leaving the hot
+// path untouched otherwise
+#ifdef USE_LD2415H_PROFILING
+#define LD2415H_PROFILE(counter) ProfileScope profile_scope_(counter)
+#else
+#define LD2415H_PROFILE(counter)
+#endif
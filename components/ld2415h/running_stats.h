@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace ld2415h {
+
+// Mean, standard deviation and extremes of a stream of values using
+// Welford's method, in constant memory.
+class RunningStats {
+ public:
+  void add(float x) {
+    this->count_++;
+    float delta = x - this->mean_;
+    this->mean_ += delta / this->count_;
+    this->m2_ += delta * (x - this->mean_);
+    if (this->count_ == 1 || x < this->min_)
+      this->min_ = x;
+    if (this->count_ == 1 || x > this->max_)
+      this->max_ = x;
+  }
+
+  void reset() {
+    this->count_ = 0;
+    this->mean_ = 0.0f;
+    this->m2_ = 0.0f;
+  }
+
+  uint32_t count() const { return this->count_; }
+  float mean() const { return this->count_ > 0 ? this->mean_ : NAN; }
+  float stddev() const { return this->count_ > 1 ? std::sqrt(this->m2_ / (this->count_ - 1)) : NAN; }
+  float min() const { return this->count_ > 0 ? this->min_ : NAN; }
+  float max() const { return this->count_ > 0 ? this->max_ : NAN; }
+
+ protected:
+  uint32_t count_{0};
+  float mean_{0.0f};
+  float m2_{0.0f};
+  float min_{0.0f};
+  float max_{0.0f};
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include "vehicle_event.h"
+
+namespace esphome {
+namespace ld2415h {
+
+static const uint8_t SAMPLE_RATE_COUNT = 3;
+
+// Chooses between an active and an idle sample rate from the speed stream.
+// A run of moving frames switches to the active rate; the idle rate returns
+// once no moving frame has been seen for the hold time.
+class SampleRateGovernor {
+ public:
+  void set_rates(uint8_t active, uint8_t idle) {
+    this->active_rate_ = active;
+    this->idle_rate_ = idle;
+    this->target_ = idle;
+  }
+  void set_hold_time(uint32_t hold_time) { this->hold_time_ = hold_time; }
+  void set_activation_frames(uint8_t frames) { this->activation_frames_ = frames; }
+
+  // Returns true when the sample moves the target to the active rate
+  bool add(const Sample &sample) {
+    if (sample.speed == 0) {
+      this->moving_frames_ = 0;
+      return false;
+    }
+
+    this->last_motion_ = sample.timestamp;
+    if (this->moving_frames_ < UINT8_MAX)
+      this->moving_frames_++;
+
+    if (this->target_ == this->active_rate_ || this->moving_frames_ < this->activation_frames_)
+      return false;
+
+    this->target_ = this->active_rate_;
+    return true;
+  }
+
+  // Returns true when the hold time has expired and the target drops to the idle rate
+  bool check_idle(uint32_t now) {
+    if (this->target_ == this->idle_rate_ || now - this->last_motion_ <= this->hold_time_)
+      return false;
+
+    this->target_ = this->idle_rate_;
+    this->moving_frames_ = 0;
+    return true;
+  }
+
+  uint8_t target() const { return this->target_; }
+  uint8_t active_rate() const { return this->active_rate_; }
+  uint8_t idle_rate() const { return this->idle_rate_; }
+  uint32_t hold_time() const { return this->hold_time_; }
+
+  // Charges the time since the last call to the rate the sensor was running at
+  void account(uint8_t rate, uint32_t now) {
+    if (this->accounting_ && this->rate_ < SAMPLE_RATE_COUNT)
+      this->rate_time_[this->rate_] += now - this->rate_since_;
+    this->rate_ = rate;
+    this->rate_since_ = now;
+    this->accounting_ = true;
+  }
+
+  // Milliseconds spent at a rate, as of the last account() call
+  uint64_t time_at(uint8_t rate) const { return rate < SAMPLE_RATE_COUNT ? this->rate_time_[rate] : 0; }
+
+ protected:
+  uint8_t active_rate_{0};
+  uint8_t idle_rate_{2};
+  uint8_t target_{2};
+  uint32_t hold_time_{5000};
+  uint8_t activation_frames_{2};
+  uint8_t moving_frames_{0};
+  uint32_t last_motion_{0};
+
+  bool accounting_{false};
+  uint8_t rate_{0};
+  uint32_t rate_since_{0};
+  uint64_t rate_time_[SAMPLE_RATE_COUNT]{};
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -2,21 +2,17 @@ import esphome.codegen as cg
 from esphome.components import select
 import esphome.config_validation as cv
 from esphome.const import ENTITY_CATEGORY_CONFIG, CONF_SAMPLE_RATE
-from .. import CONF_LD2415H_ID, LD2415HComponent, ld2415h_ns
+from .. import (
+    CONF_LD2415H_ID,
+    LD2415HComponent,
+    ld2415h_ns,
+    SAMPLE_RATE_OPTIONS,
+    TRACKING_MODE_OPTIONS,
+)
 
-CONF_SAMPLE_RATE_SELECTS = [
-    "~22 fps",
-    "~11 fps",
-    "~6 fps",
-]
 ICON_CLOCK_FAST = "mdi:clock-fast"
 
 CONF_TRACKING_MODE = "tracking_mode"
-CONF_TRACKING_MODE_SELECTS = [
-    "Approaching and Retreating",
-    "Approaching",
-    "Retreating",
-]
 ICON_RADAR = "mdi:radar"
 
 SampleRateSelect = ld2415h_ns.class_("SampleRateSelect", select.Select)
@@ -42,14 +38,14 @@ async def to_code(config):
     if sample_rate_config := config.get(CONF_SAMPLE_RATE):
         sel = await select.new_select(
             sample_rate_config,
-            options=[CONF_SAMPLE_RATE_SELECTS],
+            options=SAMPLE_RATE_OPTIONS,
         )
         await cg.register_parented(sel, config[CONF_LD2415H_ID])
         cg.add(ld2415h_component.set_sample_rate_select(sel))
     if tracking_mode_config := config.get(CONF_TRACKING_MODE):
         sel = await select.new_select(
             tracking_mode_config,
-            options=[CONF_TRACKING_MODE_SELECTS],
+            options=TRACKING_MODE_OPTIONS,
         )
         await cg.register_parented(sel, config[CONF_LD2415H_ID])
         cg.add(ld2415h_component.set_tracking_mode_select(sel))
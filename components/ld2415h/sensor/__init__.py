@@ -1,20 +1,96 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
+from esphome import automation
 from esphome.components import sensor
 from esphome.const import (
+    CONF_ACCELERATION,
+    CONF_DISTANCE,
     CONF_ID,
     CONF_SPEED,
+    CONF_TRIGGER_ID,
+    DEVICE_CLASS_DISTANCE,
+    DEVICE_CLASS_DURATION,
     DEVICE_CLASS_SPEED,
+    ENTITY_CATEGORY_DIAGNOSTIC,
     STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_EMPTY,
     UNIT_KILOMETER_PER_HOUR,
+    UNIT_METER,
+    UNIT_METER_PER_SECOND_SQUARED,
+    UNIT_MILLISECOND,
+    UNIT_SECOND,
 )
 from .. import ld2415h_ns, LD2415HComponent, CONF_LD2415H_ID
 
 CONF_VELOCITY = "velocity"
+CONF_DROPPED_FRAMES = "dropped_frames"
+CONF_COMMAND_LATENCY = "command_latency"
+CONF_COMMAND_RETRIES = "command_retries"
+CONF_COMMAND_FAILURES = "command_failures"
+CONF_BUFFER_OVERRUNS = "buffer_overruns"
+CONF_UNKNOWN_FRAMES = "unknown_frames"
+CONF_PARSE_FAILURES = "parse_failures"
+CONF_FRAME_JITTER = "frame_jitter"
+CONF_PUBLISH_LATENCY = "publish_latency"
+CONF_LOOP_DRAIN_TIME = "loop_drain_time"
+CONF_CONFIG_WRITES = "config_writes"
+CONF_RECONFIGURATION_LOST_FRAMES = "reconfiguration_lost_frames"
+CONF_TRIGGER_ACTIVATIONS = "trigger_activations"
+CONF_TRIGGER_LATENCY = "trigger_latency"
+CONF_TIME_AT_22FPS = "time_at_22fps"
+CONF_TIME_AT_11FPS = "time_at_11fps"
+CONF_TIME_AT_6FPS = "time_at_6fps"
+CONF_VEHICLE_COUNT = "vehicle_count"
+CONF_APPROACHING_VEHICLE_COUNT = "approaching_vehicle_count"
+CONF_RETREATING_VEHICLE_COUNT = "retreating_vehicle_count"
+CONF_OVERLAPPING_VEHICLE_COUNT = "overlapping_vehicle_count"
+CONF_VEHICLE_MAX_SPEED = "vehicle_max_speed"
+CONF_VEHICLE_MEAN_SPEED = "vehicle_mean_speed"
+CONF_VEHICLE_DURATION = "vehicle_duration"
+CONF_VEHICLE_FRAMES = "vehicle_frames"
+CONF_DEADBAND = "deadband"
+CONF_MIN_INTERVAL = "min_interval"
+CONF_KEYFRAME_INTERVAL = "keyframe_interval"
+CONF_ZERO_TIMEOUT = "zero_timeout"
+CONF_PUBLISHED_UPDATES = "published_updates"
+CONF_SUPPRESSED_UPDATES = "suppressed_updates"
+CONF_TRAFFIC_STATISTICS = "traffic_statistics"
+CONF_WINDOW = "window"
+CONF_PERCENTILE = "percentile"
+CONF_PERCENTILE_SPEED = "percentile_speed"
+CONF_MEAN_SPEED = "mean_speed"
+CONF_COUNT = "count"
+CONF_APPROACHING_COUNT = "approaching_count"
+CONF_RETREATING_COUNT = "retreating_count"
+CONF_SPEED_BINS = "speed_bins"
+CONF_MIN_SPEED = "min_speed"
+CONF_MAX_SPEED = "max_speed"
+CONF_ARRIVAL = "arrival"
+CONF_DETECTION_RANGE = "detection_range"
+CONF_ARRIVAL_OFFSET = "arrival_offset"
+CONF_ALPHA = "alpha"
+CONF_BETA = "beta"
+CONF_ETA = "eta"
+CONF_ETA_THRESHOLD = "eta_threshold"
+CONF_ON_ETA = "on_eta"
 
-LD2415HSensor = ld2415h_ns.class_("LD2415HSensor", sensor.Sensor, cg.Component)
+MAX_SPEED_BINS = 8
+
+# Index of each sample rate, matching SampleRateStructure
+SAMPLE_RATE_TIME_KEYS = [CONF_TIME_AT_22FPS, CONF_TIME_AT_11FPS, CONF_TIME_AT_6FPS]
+
+LD2415HSensor = ld2415h_ns.class_(
+    "LD2415HSensor", sensor.Sensor, cg.PollingComponent
+)
+TrafficStatistics = ld2415h_ns.class_("TrafficStatistics", cg.Component)
+ArrivalEstimator = ld2415h_ns.class_("ArrivalEstimator", cg.PollingComponent)
+EtaTrigger = ld2415h_ns.class_("EtaTrigger", automation.Trigger.template(cg.float_))
 
 ICON_SPEEDOMETER = "mdi:speedometer"
+ICON_COUNTER = "mdi:counter"
+ICON_CAR = "mdi:car"
+ICON_TIMER = "mdi:timer-outline"
 
 speed_schema = sensor.sensor_schema(
     device_class=DEVICE_CLASS_SPEED,
@@ -32,20 +108,213 @@ velocity_schema = sensor.sensor_schema(
     accuracy_decimals=1,
 )
 
+vehicle_speed_schema = sensor.sensor_schema(
+    device_class=DEVICE_CLASS_SPEED,
+    state_class=STATE_CLASS_MEASUREMENT,
+    unit_of_measurement=UNIT_KILOMETER_PER_HOUR,
+    icon=ICON_CAR,
+    accuracy_decimals=1,
+)
+
+diagnostic_counter_schema = sensor.sensor_schema(
+    unit_of_measurement=UNIT_EMPTY,
+    icon=ICON_COUNTER,
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+diagnostic_timing_schema = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MILLISECOND,
+    icon=ICON_TIMER,
+    accuracy_decimals=2,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+sample_rate_time_schema = sensor.sensor_schema(
+    unit_of_measurement=UNIT_SECOND,
+    icon=ICON_TIMER,
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+window_count_schema = sensor.sensor_schema(
+    unit_of_measurement=UNIT_EMPTY,
+    icon=ICON_CAR,
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_MEASUREMENT,
+)
+
+SPEED_BIN_SCHEMA = window_count_schema.extend(
+    {
+        cv.Required(CONF_MIN_SPEED): cv.float_range(min=0, max=999),
+        cv.Required(CONF_MAX_SPEED): cv.float_range(min=0, max=999),
+    }
+)
+
+TRAFFIC_STATISTICS_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(TrafficStatistics),
+        cv.Optional(CONF_WINDOW, default="5min"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(min=cv.TimePeriod(seconds=1)),
+        ),
+        cv.Optional(CONF_PERCENTILE, default=85): cv.float_range(min=1, max=99),
+        cv.Optional(CONF_PERCENTILE_SPEED): vehicle_speed_schema,
+        cv.Optional(CONF_MEAN_SPEED): vehicle_speed_schema,
+        cv.Optional(CONF_COUNT): window_count_schema,
+        cv.Optional(CONF_APPROACHING_COUNT): window_count_schema,
+        cv.Optional(CONF_RETREATING_COUNT): window_count_schema,
+        cv.Optional(CONF_SPEED_BINS): cv.All(
+            cv.ensure_list(SPEED_BIN_SCHEMA), cv.Length(max=MAX_SPEED_BINS)
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+ARRIVAL_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(ArrivalEstimator),
+        cv.Required(CONF_DETECTION_RANGE): cv.All(cv.distance, cv.Range(min=1.0)),
+        cv.Optional(CONF_ARRIVAL_OFFSET, default="0m"): cv.distance,
+        cv.Optional(CONF_ALPHA, default=0.5): cv.float_range(min=0, max=1),
+        cv.Optional(CONF_BETA, default=0.1): cv.float_range(min=0, max=1),
+        cv.Optional(
+            CONF_ETA_THRESHOLD, default="3s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_SPEED): speed_schema,
+        cv.Optional(CONF_ACCELERATION): sensor.sensor_schema(
+            unit_of_measurement=UNIT_METER_PER_SECOND_SQUARED,
+            icon=ICON_SPEEDOMETER,
+            accuracy_decimals=2,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_DISTANCE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_METER,
+            device_class=DEVICE_CLASS_DISTANCE,
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_ETA): sensor.sensor_schema(
+            unit_of_measurement=UNIT_SECOND,
+            device_class=DEVICE_CLASS_DURATION,
+            icon=ICON_TIMER,
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_ON_ETA): automation.validate_automation(
+            {
+                cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(EtaTrigger),
+            }
+        ),
+    }
+).extend(cv.polling_component_schema("500ms"))
+
 CONFIG_SCHEMA = cv.Schema(
     {
         cv.GenerateID(): cv.declare_id(LD2415HSensor),
         cv.GenerateID(CONF_LD2415H_ID): cv.use_id(LD2415HComponent),
         cv.Optional(CONF_SPEED): speed_schema,
         cv.Optional(CONF_VELOCITY): velocity_schema,
+        cv.Optional(CONF_DEADBAND, default=0): cv.float_range(min=0, max=100),
+        cv.Optional(
+            CONF_MIN_INTERVAL, default="0ms"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(
+            CONF_KEYFRAME_INTERVAL, default="0ms"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(
+            CONF_ZERO_TIMEOUT, default="0ms"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_PUBLISHED_UPDATES): diagnostic_counter_schema,
+        cv.Optional(CONF_SUPPRESSED_UPDATES): diagnostic_counter_schema,
+        cv.Optional(CONF_DROPPED_FRAMES): diagnostic_counter_schema,
+        cv.Optional(CONF_COMMAND_LATENCY): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            icon=ICON_TIMER,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_COMMAND_RETRIES): diagnostic_counter_schema,
+        cv.Optional(CONF_COMMAND_FAILURES): diagnostic_counter_schema,
+        cv.Optional(CONF_BUFFER_OVERRUNS): diagnostic_counter_schema,
+        cv.Optional(CONF_UNKNOWN_FRAMES): diagnostic_counter_schema,
+        cv.Optional(CONF_PARSE_FAILURES): diagnostic_counter_schema,
+        cv.Optional(CONF_FRAME_JITTER): diagnostic_timing_schema,
+        cv.Optional(CONF_PUBLISH_LATENCY): diagnostic_timing_schema,
+        cv.Optional(CONF_LOOP_DRAIN_TIME): diagnostic_timing_schema,
+        cv.Optional(CONF_CONFIG_WRITES): diagnostic_counter_schema,
+        cv.Optional(CONF_RECONFIGURATION_LOST_FRAMES): diagnostic_counter_schema,
+        cv.Optional(CONF_TRIGGER_ACTIVATIONS): diagnostic_counter_schema,
+        cv.Optional(CONF_TRIGGER_LATENCY): diagnostic_timing_schema,
+        cv.Optional(CONF_TIME_AT_22FPS): sample_rate_time_schema,
+        cv.Optional(CONF_TIME_AT_11FPS): sample_rate_time_schema,
+        cv.Optional(CONF_TIME_AT_6FPS): sample_rate_time_schema,
+        cv.Optional(CONF_VEHICLE_COUNT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_EMPTY,
+            icon=ICON_CAR,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+        ),
+        cv.Optional(CONF_APPROACHING_VEHICLE_COUNT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_EMPTY,
+            icon=ICON_CAR,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+        ),
+        cv.Optional(CONF_RETREATING_VEHICLE_COUNT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_EMPTY,
+            icon=ICON_CAR,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+        ),
+        cv.Optional(CONF_OVERLAPPING_VEHICLE_COUNT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_EMPTY,
+            icon=ICON_CAR,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+        ),
+        cv.Optional(CONF_VEHICLE_MAX_SPEED): vehicle_speed_schema,
+        cv.Optional(CONF_VEHICLE_MEAN_SPEED): vehicle_speed_schema,
+        cv.Optional(CONF_VEHICLE_DURATION): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            icon=ICON_TIMER,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_VEHICLE_FRAMES): sensor.sensor_schema(
+            unit_of_measurement=UNIT_EMPTY,
+            icon=ICON_COUNTER,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+        ),
+        cv.Optional(CONF_TRAFFIC_STATISTICS): cv.ensure_list(
+            TRAFFIC_STATISTICS_SCHEMA
+        ),
+        cv.Optional(CONF_ARRIVAL): ARRIVAL_SCHEMA,
     }
-).extend(cv.COMPONENT_SCHEMA)
+).extend(cv.polling_component_schema("60s"))
 
 
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
 
+    cg.add(var.set_deadband(config[CONF_DEADBAND]))
+    cg.add(var.set_min_interval(config[CONF_MIN_INTERVAL]))
+    cg.add(var.set_keyframe_interval(config[CONF_KEYFRAME_INTERVAL]))
+    cg.add(var.set_zero_timeout(config[CONF_ZERO_TIMEOUT]))
+
+    if published_updates := config.get(CONF_PUBLISHED_UPDATES):
+        sens = await sensor.new_sensor(published_updates)
+        cg.add(var.set_published_updates_sensor(sens))
+
+    if suppressed_updates := config.get(CONF_SUPPRESSED_UPDATES):
+        sens = await sensor.new_sensor(suppressed_updates)
+        cg.add(var.set_suppressed_updates_sensor(sens))
+
     if speed := config.get(CONF_SPEED):
         sens = await sensor.new_sensor(speed)
         cg.add(var.set_speed_sensor(sens))
@@ -53,6 +322,176 @@ async def to_code(config):
     if velocity := config.get(CONF_VELOCITY):
         sens = await sensor.new_sensor(velocity)
         cg.add(var.set_velocity_sensor(sens))
-        
+
+    if vehicle_count := config.get(CONF_VEHICLE_COUNT):
+        sens = await sensor.new_sensor(vehicle_count)
+        cg.add(var.set_vehicle_count_sensor(sens))
+
+    if approaching_vehicle_count := config.get(CONF_APPROACHING_VEHICLE_COUNT):
+        sens = await sensor.new_sensor(approaching_vehicle_count)
+        cg.add(var.set_approaching_vehicle_count_sensor(sens))
+
+    if retreating_vehicle_count := config.get(CONF_RETREATING_VEHICLE_COUNT):
+        sens = await sensor.new_sensor(retreating_vehicle_count)
+        cg.add(var.set_retreating_vehicle_count_sensor(sens))
+
+    if overlapping_vehicle_count := config.get(CONF_OVERLAPPING_VEHICLE_COUNT):
+        sens = await sensor.new_sensor(overlapping_vehicle_count)
+        cg.add(var.set_overlapping_vehicle_count_sensor(sens))
+
+    if vehicle_max_speed := config.get(CONF_VEHICLE_MAX_SPEED):
+        sens = await sensor.new_sensor(vehicle_max_speed)
+        cg.add(var.set_vehicle_max_speed_sensor(sens))
+
+    if vehicle_mean_speed := config.get(CONF_VEHICLE_MEAN_SPEED):
+        sens = await sensor.new_sensor(vehicle_mean_speed)
+        cg.add(var.set_vehicle_mean_speed_sensor(sens))
+
+    if vehicle_duration := config.get(CONF_VEHICLE_DURATION):
+        sens = await sensor.new_sensor(vehicle_duration)
+        cg.add(var.set_vehicle_duration_sensor(sens))
+
+    if vehicle_frames := config.get(CONF_VEHICLE_FRAMES):
+        sens = await sensor.new_sensor(vehicle_frames)
+        cg.add(var.set_vehicle_frames_sensor(sens))
+
     ld2415h = await cg.get_variable(config[CONF_LD2415H_ID])
     cg.add(ld2415h.register_listener(var))
+
+    if dropped_frames := config.get(CONF_DROPPED_FRAMES):
+        sens = await sensor.new_sensor(dropped_frames)
+        cg.add(ld2415h.set_dropped_frames_sensor(sens))
+
+    if command_latency := config.get(CONF_COMMAND_LATENCY):
+        sens = await sensor.new_sensor(command_latency)
+        cg.add(ld2415h.set_command_latency_sensor(sens))
+
+    if command_retries := config.get(CONF_COMMAND_RETRIES):
+        sens = await sensor.new_sensor(command_retries)
+        cg.add(ld2415h.set_command_retries_sensor(sens))
+
+    if command_failures := config.get(CONF_COMMAND_FAILURES):
+        sens = await sensor.new_sensor(command_failures)
+        cg.add(ld2415h.set_command_failures_sensor(sens))
+
+    if buffer_overruns := config.get(CONF_BUFFER_OVERRUNS):
+        sens = await sensor.new_sensor(buffer_overruns)
+        cg.add(ld2415h.set_buffer_overruns_sensor(sens))
+
+    if unknown_frames := config.get(CONF_UNKNOWN_FRAMES):
+        sens = await sensor.new_sensor(unknown_frames)
+        cg.add(ld2415h.set_unknown_frames_sensor(sens))
+
+    if parse_failures := config.get(CONF_PARSE_FAILURES):
+        sens = await sensor.new_sensor(parse_failures)
+        cg.add(ld2415h.set_parse_failures_sensor(sens))
+
+    if frame_jitter := config.get(CONF_FRAME_JITTER):
+        sens = await sensor.new_sensor(frame_jitter)
+        cg.add(ld2415h.set_frame_jitter_sensor(sens))
+
+    if publish_latency := config.get(CONF_PUBLISH_LATENCY):
+        sens = await sensor.new_sensor(publish_latency)
+        cg.add(ld2415h.set_publish_latency_sensor(sens))
+
+    if loop_drain_time := config.get(CONF_LOOP_DRAIN_TIME):
+        sens = await sensor.new_sensor(loop_drain_time)
+        cg.add(ld2415h.set_loop_drain_time_sensor(sens))
+
+    if config_writes := config.get(CONF_CONFIG_WRITES):
+        sens = await sensor.new_sensor(config_writes)
+        cg.add(ld2415h.set_config_writes_sensor(sens))
+
+    if reconfiguration_lost_frames := config.get(CONF_RECONFIGURATION_LOST_FRAMES):
+        sens = await sensor.new_sensor(reconfiguration_lost_frames)
+        cg.add(ld2415h.set_reconfig_lost_frames_sensor(sens))
+
+    if trigger_activations := config.get(CONF_TRIGGER_ACTIVATIONS):
+        sens = await sensor.new_sensor(trigger_activations)
+        cg.add(ld2415h.set_trigger_activations_sensor(sens))
+
+    if trigger_latency := config.get(CONF_TRIGGER_LATENCY):
+        sens = await sensor.new_sensor(trigger_latency)
+        cg.add(ld2415h.set_trigger_latency_sensor(sens))
+
+    for rate, key in enumerate(SAMPLE_RATE_TIME_KEYS):
+        if sample_rate_time := config.get(key):
+            sens = await sensor.new_sensor(sample_rate_time)
+            cg.add(ld2415h.set_sample_rate_time_sensor(rate, sens))
+
+    for stats_config in config.get(CONF_TRAFFIC_STATISTICS, []):
+        await traffic_statistics_to_code(ld2415h, stats_config)
+
+    if arrival_config := config.get(CONF_ARRIVAL):
+        await arrival_to_code(ld2415h, arrival_config)
+
+
+async def traffic_statistics_to_code(ld2415h, config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add(var.set_window(config[CONF_WINDOW]))
+    cg.add(var.set_percentile(config[CONF_PERCENTILE]))
+
+    if percentile_speed := config.get(CONF_PERCENTILE_SPEED):
+        sens = await sensor.new_sensor(percentile_speed)
+        cg.add(var.set_percentile_speed_sensor(sens))
+
+    if mean_speed := config.get(CONF_MEAN_SPEED):
+        sens = await sensor.new_sensor(mean_speed)
+        cg.add(var.set_mean_speed_sensor(sens))
+
+    if count := config.get(CONF_COUNT):
+        sens = await sensor.new_sensor(count)
+        cg.add(var.set_count_sensor(sens))
+
+    if approaching_count := config.get(CONF_APPROACHING_COUNT):
+        sens = await sensor.new_sensor(approaching_count)
+        cg.add(var.set_approaching_count_sensor(sens))
+
+    if retreating_count := config.get(CONF_RETREATING_COUNT):
+        sens = await sensor.new_sensor(retreating_count)
+        cg.add(var.set_retreating_count_sensor(sens))
+
+    for bin_config in config.get(CONF_SPEED_BINS, []):
+        sens = await sensor.new_sensor(bin_config)
+        cg.add(
+            var.add_speed_bin(
+                bin_config[CONF_MIN_SPEED], bin_config[CONF_MAX_SPEED], sens
+            )
+        )
+
+    cg.add(ld2415h.register_listener(var))
+
+
+async def arrival_to_code(ld2415h, config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add(var.set_parent(ld2415h))
+    cg.add(var.set_detection_range(config[CONF_DETECTION_RANGE]))
+    cg.add(var.set_arrival_offset(config[CONF_ARRIVAL_OFFSET]))
+    cg.add(var.set_filter_gains(config[CONF_ALPHA], config[CONF_BETA]))
+    cg.add(
+        var.set_eta_threshold(config[CONF_ETA_THRESHOLD].total_milliseconds / 1000)
+    )
+
+    if speed := config.get(CONF_SPEED):
+        sens = await sensor.new_sensor(speed)
+        cg.add(var.set_speed_sensor(sens))
+
+    if acceleration := config.get(CONF_ACCELERATION):
+        sens = await sensor.new_sensor(acceleration)
+        cg.add(var.set_acceleration_sensor(sens))
+
+    if distance := config.get(CONF_DISTANCE):
+        sens = await sensor.new_sensor(distance)
+        cg.add(var.set_distance_sensor(sens))
+
+    if eta := config.get(CONF_ETA):
+        sens = await sensor.new_sensor(eta)
+        cg.add(var.set_eta_sensor(sens))
+
+    for conf in config.get(CONF_ON_ETA, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [(float, "eta")], conf)
+
+    cg.add(ld2415h.register_listener(var))
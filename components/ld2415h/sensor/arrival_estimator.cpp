@@ -0,0 +1,127 @@
+#include "arrival_estimator.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace ld2415h {
+
+static const char *const TAG = "LD2415H.arrival_estimator";
+
+void ArrivalEstimator::dump_config() {
+  ESP_LOGCONFIG(TAG, "LD2415H Arrival Estimator:");
+  ESP_LOGCONFIG(TAG, "  Detection Range: %.1f m", this->detection_range_);
+  ESP_LOGCONFIG(TAG, "  Arrival Offset: %.1f m", this->arrival_offset_);
+  ESP_LOGCONFIG(TAG, "  ETA Threshold: %.1f s", this->eta_threshold_);
+  LOG_UPDATE_INTERVAL(this);
+  LOG_SENSOR("  ", "Speed", this->speed_sensor_);
+  LOG_SENSOR("  ", "Acceleration", this->acceleration_sensor_);
+  LOG_SENSOR("  ", "Distance", this->distance_sensor_);
+  LOG_SENSOR("  ", "ETA", this->eta_sensor_);
+}
+
+void ArrivalEstimator::on_sample(const Sample &sample) {
+  // Only approaching targets have an arrival; zero frames carry no motion
+  if (sample.velocity <= 0)
+    return;
+
+  float speed = sample.velocity / 36.0f;  // Tenths of km/h to m/s
+  uint32_t elapsed = sample.timestamp_us - this->last_us_;
+
+  if (!this->tracking_ || elapsed > this->parent_->get_event_gap() * 1000) {
+    this->start_track_(sample);
+    return;
+  }
+
+  float dt = elapsed / 1e6f;
+  this->filter_.update(speed, dt);
+  this->distance_ -= this->filter_.value() * dt;
+  this->last_us_ = sample.timestamp_us;
+
+  this->eta_ = this->estimate_eta_();
+
+  // Evaluated per frame rather than at update() so the warning is not delayed
+  if (!this->triggered_ && this->eta_ < this->eta_threshold_) {
+    this->triggered_ = true;
+    ESP_LOGD(TAG, "ETA %.1f s at %.1f m", this->eta_, this->distance_);
+    this->eta_callback_.call(this->eta_);
+  }
+}
+
+float ArrivalEstimator::estimate_eta_() const {
+  float speed = this->filter_.value();
+  float accel = this->filter_.rate();
+
+  if (this->distance_ <= 0.0f)
+    return 0.0f;
+  if (speed < ARRIVAL_MIN_SPEED)
+    return NAN;
+  if (std::fabs(accel) < ARRIVAL_MIN_ACCELERATION)
+    return this->distance_ / speed;
+
+  // Solve distance = speed * t + accel * t^2 / 2; no real root means the
+  // target stops before it arrives
+  float discriminant = speed * speed + 2.0f * accel * this->distance_;
+  if (discriminant < 0.0f)
+    return NAN;
+  return (std::sqrt(discriminant) - speed) / accel;
+}
+
+void ArrivalEstimator::on_vehicle_event(const VehicleEvent &event) {
+  // Events also arrive for retreating vehicles and, with several vehicles in
+  // the beam, for an approaching one that left before this target was seen
+  if (!this->tracking_ || event.direction != Direction::DIRECTION_APPROACHING)
+    return;
+  if (static_cast<int32_t>(event.start + event.duration - this->track_start_) < 0)
+    return;
+
+  this->tracking_ = false;
+  this->distance_ = NAN;
+  this->eta_ = NAN;
+}
+
+void ArrivalEstimator::start_track_(const Sample &sample) {
+  // Project the detection range onto the road using the configured beam angle
+  float angle = this->parent_->get_compensation_angle() * static_cast<float>(M_PI) / 180.0f;
+
+  this->tracking_ = true;
+  this->triggered_ = false;
+  this->idle_published_ = false;
+  this->last_us_ = sample.timestamp_us;
+  this->track_start_ = sample.timestamp;
+  this->filter_.reset(sample.velocity / 36.0f);
+  this->distance_ = this->detection_range_ * std::cos(angle) + this->arrival_offset_;
+  this->eta_ = NAN;
+}
+
+void ArrivalEstimator::update() {
+  if (!this->tracking_) {
+    this->publish_idle_();
+    return;
+  }
+
+  if (this->speed_sensor_ != nullptr)
+    this->speed_sensor_->publish_state(this->filter_.value() * 3.6f);
+  if (this->acceleration_sensor_ != nullptr)
+    this->acceleration_sensor_->publish_state(this->filter_.rate());
+  if (this->distance_sensor_ != nullptr)
+    this->distance_sensor_->publish_state(this->distance_);
+  if (this->eta_sensor_ != nullptr)
+    this->eta_sensor_->publish_state(this->eta_);
+}
+
+void ArrivalEstimator::publish_idle_() {
+  if (this->idle_published_)
+    return;
+  this->idle_published_ = true;
+
+  if (this->speed_sensor_ != nullptr)
+    this->speed_sensor_->publish_state(0.0f);
+  if (this->acceleration_sensor_ != nullptr)
+    this->acceleration_sensor_->publish_state(0.0f);
+  if (this->distance_sensor_ != nullptr)
+    this->distance_sensor_->publish_state(NAN);
+  if (this->eta_sensor_ != nullptr)
+    this->eta_sensor_->publish_state(NAN);
+}
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../alpha_beta_filter.h"
+#include "../ld2415h.h"
+#include "esphome/core/automation.h"
+#include "esphome/core/helpers.h"
+#include "esphome/components/sensor/sensor.h"
+
+namespace esphome {
+namespace ld2415h {
+
+// Below this speed an approaching target is treated as stopped and has no ETA
+static const float ARRIVAL_MIN_SPEED = 0.5f;  // m/s
+// Below this the ETA assumes constant speed
+static const float ARRIVAL_MIN_ACCELERATION = 0.1f;  // m/s^2
+
+// Estimates distance and time to arrival of an approaching target by
+// integrating its filtered velocity from the point where it entered the beam.
+// The sensor does not report range, so the distance at first detection comes
+// from the configured detection range and the compensation angle.
+class ArrivalEstimator : public LD2415HListener, public PollingComponent, public Parented<LD2415HComponent> {
+ public:
+  void update() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  void set_detection_range(float range) { this->detection_range_ = range; }
+  void set_arrival_offset(float offset) { this->arrival_offset_ = offset; }
+  void set_filter_gains(float alpha, float beta) { this->filter_.set_gains(alpha, beta); }
+  void set_eta_threshold(float threshold) { this->eta_threshold_ = threshold; }
+  void set_speed_sensor(sensor::Sensor *sensor) { this->speed_sensor_ = sensor; }
+  void set_acceleration_sensor(sensor::Sensor *sensor) { this->acceleration_sensor_ = sensor; }
+  void set_distance_sensor(sensor::Sensor *sensor) { this->distance_sensor_ = sensor; }
+  void set_eta_sensor(sensor::Sensor *sensor) { this->eta_sensor_ = sensor; }
+  void add_on_eta_callback(std::function<void(float)> &&callback) { this->eta_callback_.add(std::move(callback)); }
+
+  void on_sample(const Sample &sample) override;
+  void on_vehicle_event(const VehicleEvent &event) override;
+
+ protected:
+  void start_track_(const Sample &sample);
+  float estimate_eta_() const;
+  void publish_idle_();
+
+  float detection_range_{50.0f};  // m along the beam
+  float arrival_offset_{0.0f};    // m along the road past the sensor
+  float eta_threshold_{3.0f};     // s
+
+  AlphaBetaFilter filter_;  // Speed in m/s and its rate of change
+  bool tracking_{false};
+  bool triggered_{false};
+  bool idle_published_{false};
+  uint32_t last_us_{0};
+  uint32_t track_start_{0};  // millis() of the first frame of the target
+  float distance_{NAN};
+  float eta_{NAN};
+
+  sensor::Sensor *speed_sensor_{nullptr};
+  sensor::Sensor *acceleration_sensor_{nullptr};
+  sensor::Sensor *distance_sensor_{nullptr};
+  sensor::Sensor *eta_sensor_{nullptr};
+  CallbackManager<void(float)> eta_callback_;
+};
+
+// Fires once per target when its ETA first falls below the threshold
+class EtaTrigger : public Trigger<float> {
+ public:
+  explicit EtaTrigger(ArrivalEstimator *parent) {
+    parent->add_on_eta_callback([this](float eta) { this->trigger(eta); });
+  }
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -9,8 +9,121 @@ static const char *const TAG = "LD2415H.sensor";
 
 void LD2415HSensor::dump_config() {
   ESP_LOGCONFIG(TAG, "LD2415H Sensor:");
-  LOG_SENSOR("  ", "Speed", this->speed_sensor_);
-  LOG_SENSOR("  ", "Velocity", this->velocity_sensor_);
+  ESP_LOGCONFIG(TAG, "  Deadband: %d.%d", this->deadband_ / 10, this->deadband_ % 10);
+  ESP_LOGCONFIG(TAG, "  Min Interval: %u ms", this->min_interval_);
+  ESP_LOGCONFIG(TAG, "  Keyframe Interval: %u ms", this->keyframe_interval_);
+  ESP_LOGCONFIG(TAG, "  Zero Timeout: %u ms", this->zero_timeout_);
+  LOG_SENSOR("  ", "Speed", this->speed_.sensor);
+  LOG_SENSOR("  ", "Velocity", this->velocity_.sensor);
+  LOG_SENSOR("  ", "Published Updates", this->published_updates_sensor_);
+  LOG_SENSOR("  ", "Suppressed Updates", this->suppressed_updates_sensor_);
+  LOG_SENSOR("  ", "Vehicle Count", this->vehicle_count_sensor_);
+  LOG_SENSOR("  ", "Approaching Vehicle Count", this->approaching_vehicle_count_sensor_);
+  LOG_SENSOR("  ", "Retreating Vehicle Count", this->retreating_vehicle_count_sensor_);
+  LOG_SENSOR("  ", "Overlapping Vehicle Count", this->overlapping_vehicle_count_sensor_);
+  LOG_SENSOR("  ", "Vehicle Max Speed", this->vehicle_max_speed_sensor_);
+  LOG_SENSOR("  ", "Vehicle Mean Speed", this->vehicle_mean_speed_sensor_);
+  LOG_SENSOR("  ", "Vehicle Duration", this->vehicle_duration_sensor_);
+  LOG_SENSOR("  ", "Vehicle Frames", this->vehicle_frames_sensor_);
+}
+
+void LD2415HSensor::loop() {
+  uint32_t now = millis();
+
+  for (Channel *channel : {&this->speed_, &this->velocity_}) {
+    if (channel->sensor == nullptr)
+      continue;
+
+    if (this->zero_timeout_ > 0 && now - this->last_sample_ >= this->zero_timeout_ && channel->published != 0 &&
+        channel->published != SPEED_UNKNOWN) {
+      // Frames have stopped, the sensor does not report zero itself
+      channel->pending = SPEED_UNKNOWN;
+      this->publish_channel_(*channel, 0, now);
+    } else if (channel->pending != SPEED_UNKNOWN && now - channel->last_publish >= this->min_interval_) {
+      // Flush a change held back by the rate limit
+      speed_t pending = channel->pending;
+      channel->pending = SPEED_UNKNOWN;
+      this->publish_channel_(*channel, pending, now);
+    } else if (this->keyframe_interval_ > 0 && channel->published != SPEED_UNKNOWN &&
+               now - channel->last_publish >= this->keyframe_interval_) {
+      this->publish_channel_(*channel, channel->published, now);
+    }
+  }
+}
+
+void LD2415HSensor::update() {
+  if (this->published_updates_sensor_ != nullptr)
+    this->published_updates_sensor_->publish_state(this->published_updates_);
+  if (this->suppressed_updates_sensor_ != nullptr)
+    this->suppressed_updates_sensor_->publish_state(this->suppressed_updates_);
+}
+
+void LD2415HSensor::on_sample(const Sample &sample) {
+  this->last_sample_ = sample.timestamp;
+  uint32_t now = millis();
+
+  this->update_channel_(this->speed_, sample.speed, now);
+  this->update_channel_(this->velocity_, sample.velocity, now);
+}
+
+void LD2415HSensor::update_channel_(Channel &channel, speed_t value, uint32_t now) {
+  if (channel.sensor == nullptr)
+    return;
+
+  if (channel.published != SPEED_UNKNOWN && abs(value - channel.published) <= this->deadband_) {
+    // Within the deadband, drop any change still waiting on the rate limit
+    channel.pending = SPEED_UNKNOWN;
+    this->suppressed_updates_++;
+    return;
+  }
+
+  if (channel.published != SPEED_UNKNOWN && now - channel.last_publish < this->min_interval_) {
+    // Held back by the rate limit, loop() publishes the latest value
+    channel.pending = value;
+    this->suppressed_updates_++;
+    return;
+  }
+
+  channel.pending = SPEED_UNKNOWN;
+  this->publish_channel_(channel, value, now);
+}
+
+void LD2415HSensor::publish_channel_(Channel &channel, speed_t value, uint32_t now) {
+  channel.published = value;
+  channel.last_publish = now;
+  this->published_updates_++;
+  channel.sensor->publish_state(speed_to_float(value));
+}
+
+void LD2415HSensor::on_vehicle_event(const VehicleEvent &event) {
+  this->vehicle_count_++;
+
+  if (this->vehicle_count_sensor_ != nullptr)
+    this->vehicle_count_sensor_->publish_state(this->vehicle_count_);
+  // Per direction, so vehicles passing each other in opposite lanes are
+  // counted in their own lane
+  if (event.direction == Direction::DIRECTION_APPROACHING) {
+    this->approaching_vehicle_count_++;
+    if (this->approaching_vehicle_count_sensor_ != nullptr)
+      this->approaching_vehicle_count_sensor_->publish_state(this->approaching_vehicle_count_);
+  } else if (event.direction == Direction::DIRECTION_RETREATING) {
+    this->retreating_vehicle_count_++;
+    if (this->retreating_vehicle_count_sensor_ != nullptr)
+      this->retreating_vehicle_count_sensor_->publish_state(this->retreating_vehicle_count_);
+  }
+  if (event.overlapped) {
+    this->overlapping_vehicle_count_++;
+    if (this->overlapping_vehicle_count_sensor_ != nullptr)
+      this->overlapping_vehicle_count_sensor_->publish_state(this->overlapping_vehicle_count_);
+  }
+  if (this->vehicle_max_speed_sensor_ != nullptr)
+    this->vehicle_max_speed_sensor_->publish_state(speed_to_float(event.max_speed));
+  if (this->vehicle_mean_speed_sensor_ != nullptr)
+    this->vehicle_mean_speed_sensor_->publish_state(speed_to_float(event.mean_speed));
+  if (this->vehicle_duration_sensor_ != nullptr)
+    this->vehicle_duration_sensor_->publish_state(event.duration);
+  if (this->vehicle_frames_sensor_ != nullptr)
+    this->vehicle_frames_sensor_->publish_state(event.frame_count);
 }
 
 }  // namespace ld2415h
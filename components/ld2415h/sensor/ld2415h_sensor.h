@@ -1,35 +1,80 @@
 #pragma once
 
+#include <cmath>
 #include "../ld2415h.h"
 #include "esphome/components/sensor/sensor.h"
 
 namespace esphome {
 namespace ld2415h {
 
-class LD2415HSensor : public LD2415HListener, public Component, sensor::Sensor {
+class LD2415HSensor : public LD2415HListener, public PollingComponent, sensor::Sensor {
  public:
+  void loop() override;
+  void update() override;
   void dump_config() override;
-  void set_speed_sensor(sensor::Sensor *sensor) { this->speed_sensor_ = sensor; }
-  void set_velocity_sensor(sensor::Sensor *velocity) { this->velocity_sensor_ = velocity; }
-  
-  void on_speed(double  speed) override {
-    if (this->speed_sensor_ != nullptr) {
-      if (this->speed_sensor_->get_state() != speed) {
-        this->speed_sensor_->publish_state(speed);
-      }
-    }
+  void set_speed_sensor(sensor::Sensor *sensor) { this->speed_.sensor = sensor; }
+  void set_velocity_sensor(sensor::Sensor *velocity) { this->velocity_.sensor = velocity; }
+  void set_vehicle_count_sensor(sensor::Sensor *sensor) { this->vehicle_count_sensor_ = sensor; }
+  void set_approaching_vehicle_count_sensor(sensor::Sensor *sensor) {
+    this->approaching_vehicle_count_sensor_ = sensor;
   }
-  void on_velocity(double  velocity) override {
-    if (this->velocity_sensor_ != nullptr) {
-      if (this->velocity_sensor_->get_state() != velocity) {
-        this->velocity_sensor_->publish_state(velocity);
-      }
-    }
+  void set_retreating_vehicle_count_sensor(sensor::Sensor *sensor) { this->retreating_vehicle_count_sensor_ = sensor; }
+  void set_overlapping_vehicle_count_sensor(sensor::Sensor *sensor) {
+    this->overlapping_vehicle_count_sensor_ = sensor;
   }
+  void set_vehicle_max_speed_sensor(sensor::Sensor *sensor) { this->vehicle_max_speed_sensor_ = sensor; }
+  void set_vehicle_mean_speed_sensor(sensor::Sensor *sensor) { this->vehicle_mean_speed_sensor_ = sensor; }
+  void set_vehicle_duration_sensor(sensor::Sensor *sensor) { this->vehicle_duration_sensor_ = sensor; }
+  void set_vehicle_frames_sensor(sensor::Sensor *sensor) { this->vehicle_frames_sensor_ = sensor; }
+  void set_published_updates_sensor(sensor::Sensor *sensor) { this->published_updates_sensor_ = sensor; }
+  void set_suppressed_updates_sensor(sensor::Sensor *sensor) { this->suppressed_updates_sensor_ = sensor; }
+
+  void set_deadband(float deadband) { this->deadband_ = static_cast<speed_t>(std::lround(deadband * 10)); }
+  void set_min_interval(uint32_t interval) { this->min_interval_ = interval; }
+  void set_keyframe_interval(uint32_t interval) { this->keyframe_interval_ = interval; }
+  void set_zero_timeout(uint32_t timeout) { this->zero_timeout_ = timeout; }
+
+  void on_sample(const Sample &sample) override;
+  void on_vehicle_event(const VehicleEvent &event) override;
 
  protected:
-  sensor::Sensor *speed_sensor_{nullptr};
-  sensor::Sensor *velocity_sensor_{nullptr};
+  // Publish state of the speed or velocity sensor
+  struct Channel {
+    sensor::Sensor *sensor{nullptr};
+    speed_t published{SPEED_UNKNOWN};
+    speed_t pending{SPEED_UNKNOWN};
+    uint32_t last_publish{0};
+  };
+
+  void update_channel_(Channel &channel, speed_t value, uint32_t now);
+  void publish_channel_(Channel &channel, speed_t value, uint32_t now);
+
+  Channel speed_;
+  Channel velocity_;
+
+  // Publish policy, applied before publish_state()
+  speed_t deadband_{0};
+  uint32_t min_interval_{0};
+  uint32_t keyframe_interval_{0};
+  uint32_t zero_timeout_{0};
+  uint32_t last_sample_{0};
+  uint32_t published_updates_{0};
+  uint32_t suppressed_updates_{0};
+  sensor::Sensor *published_updates_sensor_{nullptr};
+  sensor::Sensor *suppressed_updates_sensor_{nullptr};
+
+  sensor::Sensor *vehicle_count_sensor_{nullptr};
+  sensor::Sensor *approaching_vehicle_count_sensor_{nullptr};
+  sensor::Sensor *retreating_vehicle_count_sensor_{nullptr};
+  sensor::Sensor *overlapping_vehicle_count_sensor_{nullptr};
+  sensor::Sensor *vehicle_max_speed_sensor_{nullptr};
+  sensor::Sensor *vehicle_mean_speed_sensor_{nullptr};
+  sensor::Sensor *vehicle_duration_sensor_{nullptr};
+  sensor::Sensor *vehicle_frames_sensor_{nullptr};
+  uint32_t vehicle_count_{0};
+  uint32_t approaching_vehicle_count_{0};
+  uint32_t retreating_vehicle_count_{0};
+  uint32_t overlapping_vehicle_count_{0};
 };
 
 }  // namespace ld2415h
@@ -0,0 +1,93 @@
+#include "traffic_statistics.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace ld2415h {
+
+static const char *const TAG = "LD2415H.traffic_statistics";
+
+void TrafficStatistics::setup() {
+  this->reset_window_();
+  this->set_interval("window", this->window_, [this]() { this->publish_window_(); });
+}
+
+void TrafficStatistics::dump_config() {
+  ESP_LOGCONFIG(TAG, "LD2415H Traffic Statistics:");
+  ESP_LOGCONFIG(TAG, "  Window: %u s", this->window_ / 1000);
+  ESP_LOGCONFIG(TAG, "  Speed Bins: %u", this->bin_count_);
+  ESP_LOGCONFIG(TAG, "  Memory: %zu bytes", sizeof(*this));
+  LOG_SENSOR("  ", "Percentile Speed", this->percentile_speed_sensor_);
+  LOG_SENSOR("  ", "Mean Speed", this->mean_speed_sensor_);
+  LOG_SENSOR("  ", "Count", this->count_sensor_);
+  LOG_SENSOR("  ", "Approaching Count", this->approaching_count_sensor_);
+  LOG_SENSOR("  ", "Retreating Count", this->retreating_count_sensor_);
+  for (uint8_t i = 0; i < this->bin_count_; i++)
+    LOG_SENSOR("  ", "Speed Bin", this->bins_[i].sensor);
+}
+
+void TrafficStatistics::add_speed_bin(float min_speed, float max_speed, sensor::Sensor *sensor) {
+  if (this->bin_count_ >= MAX_SPEED_BINS) {
+    ESP_LOGE(TAG, "Too many speed bins, maximum is %u", MAX_SPEED_BINS);
+    return;
+  }
+
+  SpeedBin &bin = this->bins_[this->bin_count_++];
+  bin.min_speed = min_speed * 10;
+  bin.max_speed = max_speed * 10;
+  bin.count = 0;
+  bin.sensor = sensor;
+}
+
+void TrafficStatistics::on_vehicle_event(const VehicleEvent &event) {
+  // Each vehicle contributes its peak speed, as in a conventional speed survey
+  this->percentile_.add(speed_to_float(event.max_speed));
+  this->speed_sum_ += event.max_speed;
+
+  if (this->count_ < UINT16_MAX)
+    this->count_++;
+  if (event.direction == Direction::DIRECTION_APPROACHING && this->approaching_count_ < UINT16_MAX)
+    this->approaching_count_++;
+  if (event.direction == Direction::DIRECTION_RETREATING && this->retreating_count_ < UINT16_MAX)
+    this->retreating_count_++;
+
+  for (uint8_t i = 0; i < this->bin_count_; i++) {
+    SpeedBin &bin = this->bins_[i];
+    if (event.max_speed >= bin.min_speed && event.max_speed < bin.max_speed && bin.count < UINT16_MAX)
+      bin.count++;
+  }
+}
+
+void TrafficStatistics::publish_window_() {
+  ESP_LOGD(TAG, "Window closed: %u vehicles", this->count_);
+
+  if (this->percentile_speed_sensor_ != nullptr)
+    this->percentile_speed_sensor_->publish_state(this->percentile_.value());
+  if (this->mean_speed_sensor_ != nullptr)
+    this->mean_speed_sensor_->publish_state(this->count_ > 0 ? this->speed_sum_ / 10.0f / this->count_ : NAN);
+  if (this->count_sensor_ != nullptr)
+    this->count_sensor_->publish_state(this->count_);
+  if (this->approaching_count_sensor_ != nullptr)
+    this->approaching_count_sensor_->publish_state(this->approaching_count_);
+  if (this->retreating_count_sensor_ != nullptr)
+    this->retreating_count_sensor_->publish_state(this->retreating_count_);
+  for (uint8_t i = 0; i < this->bin_count_; i++) {
+    if (this->bins_[i].sensor != nullptr)
+      this->bins_[i].sensor->publish_state(this->bins_[i].count);
+  }
+
+  this->reset_window_();
+}
+
+void TrafficStatistics::reset_window_() {
+  this->percentile_.reset();
+  this->speed_sum_ = 0;
+  this->count_ = 0;
+  this->approaching_count_ = 0;
+  this->retreating_count_ = 0;
+  for (uint8_t i = 0; i < this->bin_count_; i++)
+    this->bins_[i].count = 0;
+}
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../ld2415h.h"
+#include "../p2_quantile.h"
+#include "esphome/components/sensor/sensor.h"
+#include <array>
+
+namespace esphome {
+namespace ld2415h {
+
+static const uint8_t MAX_SPEED_BINS = 8;
+
+// Aggregates vehicle events over a fixed window and publishes the results at
+// each window boundary. All state is preallocated.
+class TrafficStatistics : public LD2415HListener, public Component {
+ public:
+  void setup() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  void set_window(uint32_t window) { this->window_ = window; }
+  void set_percentile(float percentile) { this->percentile_.set_quantile(percentile / 100.0f); }
+  void set_percentile_speed_sensor(sensor::Sensor *sensor) { this->percentile_speed_sensor_ = sensor; }
+  void set_mean_speed_sensor(sensor::Sensor *sensor) { this->mean_speed_sensor_ = sensor; }
+  void set_count_sensor(sensor::Sensor *sensor) { this->count_sensor_ = sensor; }
+  void set_approaching_count_sensor(sensor::Sensor *sensor) { this->approaching_count_sensor_ = sensor; }
+  void set_retreating_count_sensor(sensor::Sensor *sensor) { this->retreating_count_sensor_ = sensor; }
+  void add_speed_bin(float min_speed, float max_speed, sensor::Sensor *sensor);
+
+  void on_vehicle_event(const VehicleEvent &event) override;
+
+ protected:
+  struct SpeedBin {
+    speed_t min_speed;  // Inclusive
+    speed_t max_speed;  // Exclusive
+    uint16_t count;
+    sensor::Sensor *sensor;
+  };
+
+  void publish_window_();
+  void reset_window_();
+
+  uint32_t window_{300000};
+  P2Quantile percentile_{0.85f};
+  int32_t speed_sum_{0};
+  uint16_t count_{0};
+  uint16_t approaching_count_{0};
+  uint16_t retreating_count_{0};
+  std::array<SpeedBin, MAX_SPEED_BINS> bins_{};
+  uint8_t bin_count_{0};
+
+  sensor::Sensor *percentile_speed_sensor_{nullptr};
+  sensor::Sensor *mean_speed_sensor_{nullptr};
+  sensor::Sensor *count_sensor_{nullptr};
+  sensor::Sensor *approaching_count_sensor_{nullptr};
+  sensor::Sensor *retreating_count_sensor_{nullptr};
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "esphome/core/hal.h"
+#include "vehicle_event.h"
+
+namespace esphome {
+namespace ld2415h {
+
+// Drives an output pin from decoded speed frames without going through the
+// main loop. The pin is set by the first frame at or above the trigger speed
+// in the configured direction and cleared once the speed falls below the
+// trigger speed less the hysteresis, or no qualifying frame has arrived for
+// the hold time. add() and check_hold() must be called from the thread
+// decoding frames; the state is atomic so loop() may read it.
+class SpeedTrigger {
+ public:
+  void set_pin(InternalGPIOPin *pin) { this->pin_ = pin; }
+  void set_speed(speed_t speed) { this->speed_ = speed; }
+  void set_hysteresis(speed_t hysteresis) { this->hysteresis_ = hysteresis; }
+  void set_direction(Direction direction) { this->direction_ = direction; }  // DIRECTION_NONE matches either
+  void set_hold_time(uint32_t hold_time) { this->hold_time_us_ = hold_time * 1000; }
+
+  bool is_configured() const { return this->pin_ != nullptr; }
+  bool is_active() const { return this->active_.load(std::memory_order_relaxed); }
+  InternalGPIOPin *get_pin() const { return this->pin_; }
+  speed_t get_speed() const { return this->speed_; }
+  speed_t get_hysteresis() const { return this->hysteresis_; }
+  Direction get_direction() const { return this->direction_; }
+  uint32_t get_hold_time() const { return this->hold_time_us_ / 1000; }
+
+  void setup() {
+    this->pin_->setup();
+    this->pin_->digital_write(false);
+  }
+
+  // Returns true when the sample sets the pin
+  bool add(const Sample &sample) {
+    bool direction = this->direction_ == DIRECTION_NONE || sample.direction == this->direction_;
+
+    if (this->active_.load(std::memory_order_relaxed)) {
+      if (direction && sample.speed >= this->speed_ - this->hysteresis_) {
+        this->last_us_.store(sample.timestamp_us, std::memory_order_relaxed);
+      } else {
+        this->release_();
+      }
+      return false;
+    }
+
+    if (!direction || sample.speed < this->speed_)
+      return false;
+
+    this->pin_->digital_write(true);
+    this->last_us_.store(sample.timestamp_us, std::memory_order_relaxed);
+    this->active_.store(true, std::memory_order_release);
+    return true;
+  }
+
+  // The sensor stops sending frames rather than reporting zero, so the pin is
+  // also released once the frames stop
+  void check_hold(uint32_t now_us) {
+    if (this->active_.load(std::memory_order_relaxed) &&
+        now_us - this->last_us_.load(std::memory_order_relaxed) > this->hold_time_us_)
+      this->release_();
+  }
+
+ protected:
+  void release_() {
+    this->pin_->digital_write(false);
+    this->active_.store(false, std::memory_order_release);
+  }
+
+  InternalGPIOPin *pin_{nullptr};
+  speed_t speed_{0};
+  speed_t hysteresis_{0};
+  Direction direction_{DIRECTION_NONE};
+  uint32_t hold_time_us_{500000};
+  std::atomic<uint32_t> last_us_{0};
+  std::atomic<bool> active_{false};
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
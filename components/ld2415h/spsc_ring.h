@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace esphome {
+namespace ld2415h {
+
+// Lock-free ring for exactly one producer and one consumer task.
+// Holds up to N - 1 items.
+template<typename T, uint16_t N> class SPSCRing {
+ public:
+  // Producer only
+  bool push(const T &item) {
+    uint16_t head = this->head_.load(std::memory_order_relaxed);
+    uint16_t next = (head + 1) % N;
+
+    if (next == this->tail_.load(std::memory_order_acquire))
+      return false;
+
+    this->items_[head] = item;
+    this->head_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only
+  bool pop(T &item) {
+    uint16_t tail = this->tail_.load(std::memory_order_relaxed);
+
+    if (tail == this->head_.load(std::memory_order_acquire))
+      return false;
+
+    item = this->items_[tail];
+    this->tail_.store((tail + 1) % N, std::memory_order_release);
+    return true;
+  }
+
+  static constexpr uint16_t capacity() { return N - 1; }
+
+ protected:
+  T items_[N];
+  std::atomic<uint16_t> head_{0};
+  std::atomic<uint16_t> tail_{0};
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
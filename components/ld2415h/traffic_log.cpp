@@ -0,0 +1,230 @@
+#include "traffic_log.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace ld2415h {
+
+static const char *const TAG = "LD2415H.traffic_log";
+
+// Bytes of page data per dump line, within the logger line limit
+static const uint8_t TRAFFIC_LOG_DUMP_CHUNK = 64;
+
+void TrafficLog::setup() {
+  // Find the most recent page; a new page is started at every boot since the
+  // record deltas are relative to millis()
+  uint32_t sequence = 0;
+  TrafficLogPage page;
+  this->slots_.reserve(this->pages_);
+  for (uint8_t slot = 0; slot < this->pages_; slot++) {
+    uint32_t key = fnv1_hash("ld2415h_log_" + this->id_ + "_" + to_string(slot));
+    this->slots_.push_back(global_preferences->make_preference<TrafficLogPage>(key, true));
+    if (this->slots_.back().load(&page) && page.sequence > sequence)
+      sequence = page.sequence;
+  }
+  this->start_page_(sequence + 1);
+
+  uint32_t key = fnv1_hash("ld2415h_log_" + this->id_);
+  this->cursor_pref_ = global_preferences->make_preference<TrafficLogCursor>(key, true);
+  if (!this->cursor_pref_.load(&this->cursor_))
+    this->cursor_ = {this->oldest_sequence_(), 0};
+
+  if (this->flush_interval_ > 0)
+    this->set_interval("flush", this->flush_interval_, [this]() { this->flush(); });
+}
+
+void TrafficLog::dump_config() {
+  ESP_LOGCONFIG(TAG, "LD2415H Traffic Log:");
+  ESP_LOGCONFIG(TAG, "  Pages: %u x %u bytes", this->pages_, TRAFFIC_LOG_PAGE_SIZE);
+  ESP_LOGCONFIG(TAG, "  Flush Interval: %u ms", this->flush_interval_);
+  ESP_LOGCONFIG(TAG, "  Current Page: %u (%u bytes used)", this->page_.sequence, this->page_.used);
+  ESP_LOGCONFIG(TAG, "  Replay Cursor: page %u offset %u", this->cursor_.sequence, this->cursor_.offset);
+  ESP_LOGCONFIG(TAG, "  Records Logged: %u", this->records_logged_);
+  ESP_LOGCONFIG(TAG, "  Pages Written: %u", this->pages_written_);
+}
+
+void TrafficLog::loop() {
+  if (this->replay_pending_)
+    this->replay_pending_ = this->replay_page_();
+}
+
+void TrafficLog::on_vehicle_event(const VehicleEvent &event) {
+  // The head varint is encoded separately, since it depends on whether the
+  // record starts a new page
+  uint8_t record[TRAFFIC_LOG_MAX_RECORD - 5];
+  uint8_t len = 0;
+  speed_t mean = std::min(event.mean_speed, event.max_speed);
+  len += encode_varint_(record + len, event.max_speed);
+  len += encode_varint_(record + len, event.max_speed - mean);
+  len += encode_varint_(record + len, event.duration / 100);
+
+  uint8_t head[5];
+  uint32_t delta = std::min<uint32_t>((event.start - this->last_start_) / 100, UINT32_MAX >> 2);
+  uint8_t head_len = encode_varint_(head, (delta << 2) | event.direction);
+  if (this->page_.used + head_len + len > TRAFFIC_LOG_PAGE_SIZE) {
+    this->flush();
+    this->start_page_(this->page_.sequence + 1);
+  }
+  if (this->page_.used == 0) {
+    // The first record of a page has no delta
+    this->page_.base_uptime = event.start;
+    head_len = encode_varint_(head, event.direction);
+  }
+
+#ifdef USE_TIME
+  // Anchor the page to wall time once the clock is set
+  if (this->page_.base_time == 0 && this->time_ != nullptr) {
+    ESPTime now = this->time_->now();
+    if (now.is_valid())
+      this->page_.base_time = now.timestamp - (millis() - this->page_.base_uptime) / 1000;
+  }
+#endif
+
+  std::memcpy(this->page_.data + this->page_.used, head, head_len);
+  std::memcpy(this->page_.data + this->page_.used + head_len, record, len);
+  // Advance by the stored delta rather than to the exact start, so the
+  // rounding of each delta does not accumulate into the decoded times
+  if (this->page_.used == 0) {
+    this->last_start_ = event.start;
+  } else {
+    this->last_start_ += delta * 100;
+  }
+  this->page_.used += head_len + len;
+  this->records_logged_++;
+  this->dirty_ = true;
+}
+
+void TrafficLog::flush() {
+  if (!this->dirty_)
+    return;
+
+  if (!this->slot_(this->page_.sequence).save(&this->page_)) {
+    ESP_LOGW(TAG, "Failed to save page %u", this->page_.sequence);
+    return;
+  }
+  global_preferences->sync();
+  this->dirty_ = false;
+  this->pages_written_++;
+  ESP_LOGV(TAG, "Saved page %u (%u bytes)", this->page_.sequence, this->page_.used);
+}
+
+void TrafficLog::dump() {
+  this->flush();
+
+  TrafficLogPage page;
+  for (uint32_t sequence = this->oldest_sequence_(); sequence <= this->page_.sequence; sequence++) {
+    if (!this->load_page_(sequence, page) || page.used == 0)
+      continue;
+
+    // Parsed by tools/ld2415h_log_decode.py
+    ESP_LOGI(TAG, "page %u %u %u %u", page.sequence, page.base_time, page.base_uptime, page.used);
+    for (uint16_t offset = 0; offset < page.used; offset += TRAFFIC_LOG_DUMP_CHUNK) {
+      uint16_t len = std::min<uint16_t>(TRAFFIC_LOG_DUMP_CHUNK, page.used - offset);
+      ESP_LOGI(TAG, "data %u %s", page.sequence, format_hex(page.data + offset, len).c_str());
+    }
+  }
+}
+
+void TrafficLog::clear() {
+  TrafficLogPage empty{};
+  for (auto &slot : this->slots_)
+    slot.save(&empty);
+
+  // Keep counting up so a dump never mixes pages from before the clear
+  this->start_page_(this->page_.sequence + 1);
+  this->cursor_ = {this->page_.sequence, 0};
+  this->cursor_pref_.save(&this->cursor_);
+  global_preferences->sync();
+  ESP_LOGI(TAG, "Cleared");
+}
+
+bool TrafficLog::load_page_(uint32_t sequence, TrafficLogPage &page) {
+  if (sequence == this->page_.sequence) {
+    page = this->page_;
+    return true;
+  }
+  return this->slot_(sequence).load(&page) && page.sequence == sequence;
+}
+
+void TrafficLog::start_page_(uint32_t sequence) {
+  this->page_ = {};
+  this->page_.sequence = sequence;
+  this->dirty_ = false;
+}
+
+bool TrafficLog::replay_page_() {
+  uint32_t oldest = this->oldest_sequence_();
+  if (this->cursor_.sequence < oldest) {
+    ESP_LOGW(TAG, "%u pages overwritten before replay", oldest - this->cursor_.sequence);
+    this->cursor_ = {oldest, 0};
+  }
+
+  TrafficLogPage page;
+  if (this->load_page_(this->cursor_.sequence, page)) {
+    uint16_t offset = this->cursor_.offset;
+    uint32_t start = page.base_uptime;
+    uint16_t replayed = 0;
+
+    // Deltas accumulate from the start of the page
+    uint16_t position = 0;
+    while (position < page.used) {
+      uint16_t record_start = position;
+      uint32_t head, max_speed, mean_delta, duration;
+      if (!decode_varint_(page.data, page.used, position, head) ||
+          !decode_varint_(page.data, page.used, position, max_speed) ||
+          !decode_varint_(page.data, page.used, position, mean_delta) ||
+          !decode_varint_(page.data, page.used, position, duration)) {
+        ESP_LOGW(TAG, "Page %u truncated at %u", page.sequence, position);
+        break;
+      }
+      start += (head >> 2) * 100;
+      if (record_start < offset)
+        continue;
+
+      VehicleEvent event{};
+      event.direction = static_cast<Direction>(head & 0x03);
+      event.max_speed = max_speed;
+      event.mean_speed = max_speed - mean_delta;
+      event.start = start;
+      event.duration = duration * 100;
+      uint32_t timestamp = page.base_time != 0 ? page.base_time + (start - page.base_uptime) / 1000 : 0;
+      this->replay_callback_.call(event, timestamp);
+      replayed++;
+    }
+
+    this->cursor_.offset = page.used;
+    ESP_LOGD(TAG, "Replayed %u records from page %u", replayed, page.sequence);
+  }
+
+  bool more = this->cursor_.sequence < this->page_.sequence;
+  if (more)
+    this->cursor_ = {this->cursor_.sequence + 1, 0};
+  this->cursor_pref_.save(&this->cursor_);
+  return more;
+}
+
+uint8_t TrafficLog::encode_varint_(uint8_t *out, uint32_t value) {
+  uint8_t len = 0;
+  while (value >= 0x80) {
+    out[len++] = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  out[len++] = value;
+  return len;
+}
+
+bool TrafficLog::decode_varint_(const uint8_t *data, uint16_t used, uint16_t &offset, uint32_t &value) {
+  value = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    if (offset >= used)
+      return false;
+    uint8_t byte = data[offset++];
+    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace ld2415h
+}  // namespace esphome
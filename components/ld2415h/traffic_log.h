@@ -0,0 +1,109 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
+#include "ld2415h.h"
+#ifdef USE_TIME
+#include "esphome/components/time/real_time_clock.h"
+#endif
+
+namespace esphome {
+namespace ld2415h {
+
+// Bytes of records held by one page
+static const uint16_t TRAFFIC_LOG_PAGE_SIZE = 240;
+// Largest encoded record: four varints of up to 5, 3, 3 and 5 bytes
+static const uint8_t TRAFFIC_LOG_MAX_RECORD = 16;
+
+// One flash slot of the circular log. Page n is stored in slot
+// (n - 1) % pages, so the slots hold the most recent pages in order.
+//
+// Each record is a run of unsigned LEB128 varints:
+//   (delta << 2) | direction   delta in 100 ms since the previous record start
+//   max_speed                  tenths of the configured unit
+//   max_speed - mean_speed
+//   duration                   100 ms units
+// A typical vehicle takes 5-6 bytes.
+struct TrafficLogPage {
+  uint32_t sequence;     // 0 marks an unused slot
+  uint32_t base_time;    // Epoch seconds at base_uptime, or 0 without a time source
+  uint32_t base_uptime;  // millis() the record deltas start from
+  uint16_t used;
+  uint8_t data[TRAFFIC_LOG_PAGE_SIZE];
+};
+
+// First record not yet replayed
+struct TrafficLogCursor {
+  uint32_t sequence;
+  uint16_t offset;
+};
+
+// Appends vehicle events to a circular log in flash so counts survive loss of
+// the network. The current page is kept in RAM and written at the flush
+// interval, when it fills and on shutdown; the oldest page is overwritten once
+// all slots are in use. Records since the last write are lost on a reset or
+// power loss, since on_shutdown() only runs for a clean restart.
+class TrafficLog : public LD2415HListener, public Component {
+ public:
+  void setup() override;
+  void dump_config() override;
+  void loop() override;
+  void on_shutdown() override { this->flush(); }
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  void set_id(const std::string &id) { this->id_ = id; }
+  void set_pages(uint8_t pages) { this->pages_ = pages; }
+  void set_flush_interval(uint32_t interval) { this->flush_interval_ = interval; }
+#ifdef USE_TIME
+  void set_time(time::RealTimeClock *time) { this->time_ = time; }
+#endif
+  void add_on_replay_callback(std::function<void(VehicleEvent, uint32_t)> &&callback) {
+    this->replay_callback_.add(std::move(callback));
+  }
+
+  void on_vehicle_event(const VehicleEvent &event) override;
+
+  // Write the current page if it has unsaved records
+  void flush();
+  // Log every stored page as hex for the host decoder
+  void dump();
+  // Pass the records not yet replayed to on_replay, one page per loop()
+  void replay() { this->replay_pending_ = true; }
+  void clear();
+
+ protected:
+  ESPPreferenceObject &slot_(uint32_t sequence) { return this->slots_[(sequence - 1) % this->pages_]; }
+  uint32_t oldest_sequence_() const {
+    return this->page_.sequence > this->pages_ ? this->page_.sequence - this->pages_ + 1 : 1;
+  }
+  bool load_page_(uint32_t sequence, TrafficLogPage &page);
+  void start_page_(uint32_t sequence);
+  bool replay_page_();
+  static uint8_t encode_varint_(uint8_t *out, uint32_t value);
+  static bool decode_varint_(const uint8_t *data, uint16_t used, uint16_t &offset, uint32_t &value);
+
+  std::string id_;
+  uint8_t pages_{8};
+  uint32_t flush_interval_{60000};
+#ifdef USE_TIME
+  time::RealTimeClock *time_{nullptr};
+#endif
+
+  // One preference per slot, created once since some platforms allocate
+  // flash on each make_preference()
+  std::vector<ESPPreferenceObject> slots_;
+  TrafficLogPage page_{};
+  uint32_t last_start_{0};  // millis() of the last record
+  bool dirty_{false};
+
+  TrafficLogCursor cursor_{};
+  ESPPreferenceObject cursor_pref_;
+  bool replay_pending_{false};
+
+  uint32_t records_logged_{0};
+  uint32_t pages_written_{0};
+  CallbackManager<void(VehicleEvent, uint32_t)> replay_callback_;
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
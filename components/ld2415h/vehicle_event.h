@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+namespace esphome {
+namespace ld2415h {
+
+// Speeds are carried as tenths of the configured unit of measure (e.g. 0.1 km/h),
+// which is the full resolution of the sensor output.
+using speed_t = int16_t;
+
+static const speed_t SPEED_UNKNOWN = INT16_MIN;
+
+inline float speed_to_float(speed_t speed) { return speed / 10.0f; }
+
+enum Direction : uint8_t { DIRECTION_NONE, DIRECTION_APPROACHING, DIRECTION_RETREATING };
+
+// A single decoded speed frame
+struct Sample {
+  speed_t speed;
+  speed_t velocity;  // Positive when approaching, negative when retreating
+  Direction direction;
+  uint32_t timestamp;     // millis() when the frame was received
+  uint32_t timestamp_us;  // micros() when the chunk holding the frame's terminator was read from the UART
+};
+
+// Summary of one object passing through the beam
+struct VehicleEvent {
+  speed_t max_speed;
+  speed_t mean_speed;
+  Direction direction;
+  uint32_t start;     // millis() of the first frame
+  uint32_t duration;  // ms between the first and last frame
+  uint16_t frame_count;
+  uint8_t track;    // Slot of the track that produced the event
+  bool overlapped;  // Another vehicle was tracked at the same time
+};
+
+// Upper bound on the vehicles tracked at once
+static const uint8_t MAX_VEHICLE_TRACKS = 4;
+
+// Accumulates the frames belonging to one vehicle
+class VehicleTrack {
+ public:
+  void start(const Sample &sample) {
+    this->first_ = sample.timestamp;
+    this->max_speed_ = 0;
+    this->speed_sum_ = 0;
+    this->velocity_sum_ = 0;
+    this->frame_count_ = 0;
+    this->overlapped_ = false;
+    this->add(sample);
+  }
+
+  void add(const Sample &sample) {
+    if (sample.speed > this->max_speed_)
+      this->max_speed_ = sample.speed;
+    this->speed_sum_ += sample.speed;
+    this->velocity_sum_ += sample.velocity;
+    this->last_ = sample.timestamp;
+    this->last_velocity_ = sample.velocity;
+    if (this->frame_count_ < UINT16_MAX)
+      this->frame_count_++;
+  }
+
+  uint32_t last() const { return this->last_; }
+  speed_t last_velocity() const { return this->last_velocity_; }
+  void mark_overlapped() { this->overlapped_ = true; }
+
+  VehicleEvent to_event(uint8_t track) const {
+    VehicleEvent event;
+    event.max_speed = this->max_speed_;
+    event.mean_speed = this->speed_sum_ / this->frame_count_;
+    if (this->velocity_sum_ > 0) {
+      event.direction = Direction::DIRECTION_APPROACHING;
+    } else if (this->velocity_sum_ < 0) {
+      event.direction = Direction::DIRECTION_RETREATING;
+    } else {
+      event.direction = Direction::DIRECTION_NONE;
+    }
+    event.start = this->first_;
+    event.duration = this->last_ - this->first_;
+    event.frame_count = this->frame_count_;
+    event.track = track;
+    event.overlapped = this->overlapped_;
+    return event;
+  }
+
+ protected:
+  uint32_t first_{0};
+  uint32_t last_{0};
+  speed_t max_speed_{0};
+  int32_t speed_sum_{0};
+  int32_t velocity_sum_{0};
+  uint16_t frame_count_{0};
+  speed_t last_velocity_{0};
+  bool overlapped_{false};
+};
+
+// Splits the frames of several vehicles in the beam into separate tracks. The
+// sensor reports one target per frame, so in dense traffic the frames of two
+// vehicles interleave; a frame joins the open track with the same sign and the
+// nearest velocity within the gate, otherwise it starts a new track. With all
+// tracks busy the stalest one is closed to make room. Memory is fixed and each
+// frame costs one pass over the tracks. With a single track every frame joins
+// the open track, which is the plain gap based segmentation.
+class VehicleTracker {
+ public:
+  void set_max_tracks(uint8_t tracks) {
+    this->max_tracks_ = std::min<uint8_t>(std::max<uint8_t>(tracks, 1), MAX_VEHICLE_TRACKS);
+  }
+  void set_gate(speed_t gate) { this->gate_ = gate; }
+  void set_gap(uint32_t gap) { this->gap_ = gap; }
+  uint8_t get_max_tracks() const { return this->max_tracks_; }
+  speed_t get_gate() const { return this->gate_; }
+
+  bool any_open() const { return this->open_count_ > 0; }
+
+  // Add a frame, calling on_close(event) for any track it ends
+  template<typename F> void add(const Sample &sample, F &&on_close) {
+    this->expire(sample.timestamp, on_close);
+
+    uint8_t match = MAX_VEHICLE_TRACKS;
+    uint8_t free = MAX_VEHICLE_TRACKS;
+    uint8_t stalest = MAX_VEHICLE_TRACKS;
+    int32_t nearest = INT32_MAX;
+    for (uint8_t i = 0; i < this->max_tracks_; i++) {
+      if (!this->open_[i]) {
+        if (free == MAX_VEHICLE_TRACKS)
+          free = i;
+        continue;
+      }
+      if (stalest == MAX_VEHICLE_TRACKS ||
+          sample.timestamp - this->tracks_[i].last() > sample.timestamp - this->tracks_[stalest].last())
+        stalest = i;
+
+      speed_t last = this->tracks_[i].last_velocity();
+      int32_t distance = std::abs(static_cast<int32_t>(sample.velocity) - last);
+      bool gated = this->max_tracks_ == 1 || ((sample.velocity > 0) == (last > 0) && distance <= this->gate_);
+      if (gated && distance < nearest) {
+        match = i;
+        nearest = distance;
+      }
+    }
+
+    if (match != MAX_VEHICLE_TRACKS) {
+      this->tracks_[match].add(sample);
+      return;
+    }
+
+    if (free == MAX_VEHICLE_TRACKS) {
+      this->close_(stalest, on_close);
+      free = stalest;
+    }
+    this->tracks_[free].start(sample);
+    this->open_[free] = true;
+    this->open_count_++;
+    if (this->open_count_ > 1) {
+      for (uint8_t i = 0; i < this->max_tracks_; i++) {
+        if (this->open_[i])
+          this->tracks_[i].mark_overlapped();
+      }
+    }
+  }
+
+  // Close the tracks with no frame within the gap
+  template<typename F> void expire(uint32_t now, F &&on_close) {
+    if (this->open_count_ == 0)
+      return;
+    for (uint8_t i = 0; i < this->max_tracks_; i++) {
+      if (this->open_[i] && now - this->tracks_[i].last() > this->gap_)
+        this->close_(i, on_close);
+    }
+  }
+
+ protected:
+  template<typename F> void close_(uint8_t track, F &&on_close) {
+    this->open_[track] = false;
+    this->open_count_--;
+    on_close(this->tracks_[track].to_event(track));
+  }
+
+  VehicleTrack tracks_[MAX_VEHICLE_TRACKS];
+  bool open_[MAX_VEHICLE_TRACKS]{};
+  uint8_t open_count_{0};
+  uint8_t max_tracks_{1};
+  speed_t gate_{50};
+  uint32_t gap_{500};
+};
+
+}  // namespace ld2415h
+}  // namespace esphome
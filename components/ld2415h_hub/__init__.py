@@ -0,0 +1,75 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome import automation
+from esphome.components.ld2415h import CONF_LD2415H_ID, LD2415HComponent
+from esphome.const import CONF_ID, CONF_TRIGGER_ID
+
+CODEOWNERS = ["@cptskippy"]
+
+DEPENDENCIES = ["ld2415h"]
+
+ld2415h_hub_ns = cg.esphome_ns.namespace("ld2415h_hub")
+LD2415HHub = ld2415h_hub_ns.class_("LD2415HHub", cg.Component)
+FusedEvent = ld2415h_hub_ns.struct("FusedEvent")
+FusedVehicleTrigger = ld2415h_hub_ns.class_(
+    "FusedVehicleTrigger", automation.Trigger.template(FusedEvent)
+)
+
+CONF_LD2415H_HUB_ID = "ld2415h_hub_id"
+CONF_RADARS = "radars"
+CONF_LANE = "lane"
+CONF_TIME_OFFSET = "time_offset"
+CONF_WINDOW = "window"
+CONF_SPEED_TOLERANCE = "speed_tolerance"
+CONF_ON_VEHICLE = "on_vehicle"
+
+MAX_RADARS = 4
+MAX_TIME_OFFSET = 60000
+
+RADAR_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_LD2415H_ID): cv.use_id(LD2415HComponent),
+        cv.Optional(CONF_LANE, default=1): cv.int_range(min=0, max=255),
+        # Milliseconds, negative when this radar sees vehicles before the others
+        cv.Optional(CONF_TIME_OFFSET, default=0): cv.int_range(
+            min=-MAX_TIME_OFFSET, max=MAX_TIME_OFFSET
+        ),
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(LD2415HHub),
+        cv.Required(CONF_RADARS): cv.All(
+            cv.ensure_list(RADAR_SCHEMA), cv.Length(min=1, max=MAX_RADARS)
+        ),
+        cv.Optional(CONF_WINDOW, default="1s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_SPEED_TOLERANCE, default=5): cv.float_range(min=0, max=100),
+        cv.Optional(CONF_ON_VEHICLE): automation.validate_automation(
+            {
+                cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(FusedVehicleTrigger),
+            }
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add(var.set_window(config[CONF_WINDOW]))
+    cg.add(var.set_speed_tolerance(config[CONF_SPEED_TOLERANCE]))
+
+    for radar_config in config[CONF_RADARS]:
+        radar = await cg.get_variable(radar_config[CONF_LD2415H_ID])
+        cg.add(
+            var.add_radar(
+                radar,
+                radar_config[CONF_LANE],
+                radar_config[CONF_TIME_OFFSET],
+            )
+        )
+
+    for conf in config.get(CONF_ON_VEHICLE, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(trigger, [(FusedEvent, "event")], conf)
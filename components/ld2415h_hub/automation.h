@@ -0,0 +1,17 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include "ld2415h_hub.h"
+
+namespace esphome {
+namespace ld2415h_hub {
+
+class FusedVehicleTrigger : public Trigger<FusedEvent> {
+ public:
+  explicit FusedVehicleTrigger(LD2415HHub *parent) {
+    parent->add_on_vehicle_callback([this](FusedEvent event) { this->trigger(event); });
+  }
+};
+
+}  // namespace ld2415h_hub
+}  // namespace esphome
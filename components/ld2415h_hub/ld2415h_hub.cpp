@@ -0,0 +1,143 @@
+#include "ld2415h_hub.h"
+#include "esphome/core/log.h"
+#include <algorithm>
+
+namespace esphome {
+namespace ld2415h_hub {
+
+static const char *const TAG = "ld2415h_hub";
+
+void LD2415HHubInput::on_vehicle_event(const VehicleEvent &event) { this->hub->on_radar_event(*this, event); }
+
+void LD2415HHub::add_radar(LD2415HComponent *radar, uint8_t lane, int32_t time_offset) {
+  if (this->radar_count_ >= MAX_RADARS) {
+    ESP_LOGE(TAG, "Too many radars, maximum is %u", MAX_RADARS);
+    return;
+  }
+
+  LD2415HHubInput &input = this->inputs_[this->radar_count_];
+  input.hub = this;
+  input.index = this->radar_count_++;
+  input.lane = lane;
+  input.time_offset = time_offset;
+  radar->register_listener(&input);
+}
+
+void LD2415HHub::dump_config() {
+  ESP_LOGCONFIG(TAG, "LD2415H Hub:");
+  ESP_LOGCONFIG(TAG, "  Radars: %u", this->radar_count_);
+  for (uint8_t i = 0; i < this->radar_count_; i++) {
+    ESP_LOGCONFIG(TAG, "    Radar %u: lane %u, offset %d ms", i, this->inputs_[i].lane, this->inputs_[i].time_offset);
+  }
+  ESP_LOGCONFIG(TAG, "  Window: %u ms", this->window_);
+  ESP_LOGCONFIG(TAG, "  Speed Tolerance: %d.%d", this->speed_tolerance_ / 10, this->speed_tolerance_ % 10);
+#ifdef USE_SENSOR
+  LOG_SENSOR("  ", "Vehicle Count", this->vehicle_count_sensor_);
+  LOG_SENSOR("  ", "Vehicle Speed", this->vehicle_speed_sensor_);
+  LOG_SENSOR("  ", "Vehicle Lane", this->vehicle_lane_sensor_);
+  LOG_SENSOR("  ", "Duplicates", this->duplicates_sensor_);
+#endif
+}
+
+void LD2415HHub::loop() {
+  uint32_t now = millis();
+
+  for (auto &pending : this->pending_) {
+    if (pending.active && now - pending.received > this->window_)
+      this->emit_(pending);
+  }
+}
+
+void LD2415HHub::on_radar_event(const LD2415HHubInput &input, const VehicleEvent &event) {
+  // Shift onto a common timeline so overlapping beams line up
+  uint32_t start = event.start - input.time_offset;
+  PendingEvent *match = nullptr;
+  PendingEvent *oldest = nullptr;
+  PendingEvent *free_slot = nullptr;
+  float match_error = 0.0f;
+  float speed_scale = std::max<ld2415h::speed_t>(this->speed_tolerance_, 1);
+
+  for (auto &pending : this->pending_) {
+    if (!pending.active) {
+      free_slot = &pending;
+      continue;
+    }
+    if (oldest == nullptr || static_cast<int32_t>(pending.received - oldest->received) < 0)
+      oldest = &pending;
+
+    const VehicleEvent &other = pending.fused.event;
+    uint32_t dt = abs(static_cast<int32_t>(start - pending.start));
+    uint32_t dv = abs(other.max_speed - event.max_speed);
+    if ((pending.radar_mask & (1 << input.index)) || other.direction != event.direction || dt > this->window_ ||
+        dv > static_cast<uint32_t>(this->speed_tolerance_))
+      continue;
+
+    // Several vehicles can be pending at once, so take the closest candidate
+    // with each error scaled by its tolerance rather than the first one
+    float error = static_cast<float>(dt) / std::max<uint32_t>(this->window_, 1) + dv / speed_scale;
+    if (match == nullptr || error < match_error) {
+      match = &pending;
+      match_error = error;
+    }
+  }
+
+  if (match != nullptr) {
+    // The same vehicle seen by another beam
+    this->duplicates_++;
+    match->radar_mask |= 1 << input.index;
+    match->fused.radar_count++;
+    VehicleEvent &fused = match->fused.event;
+    if (event.max_speed > fused.max_speed)
+      fused.max_speed = event.max_speed;
+    // The radar with the most frames had the strongest view of the vehicle
+    if (event.frame_count > match->lane_frames) {
+      match->lane_frames = event.frame_count;
+      match->fused.lane = input.lane;
+      fused.mean_speed = event.mean_speed;
+      fused.start = start;
+      fused.duration = event.duration;
+      fused.frame_count = event.frame_count;
+    }
+    return;
+  }
+
+  if (free_slot == nullptr) {
+    this->emit_(*oldest);
+    free_slot = oldest;
+  }
+
+  free_slot->active = true;
+  free_slot->received = millis();
+  free_slot->start = start;
+  free_slot->radar_mask = 1 << input.index;
+  free_slot->lane_frames = event.frame_count;
+  free_slot->fused.event = event;
+  free_slot->fused.event.start = start;
+  free_slot->fused.lane = input.lane;
+  free_slot->fused.radar_count = 1;
+}
+
+void LD2415HHub::emit_(PendingEvent &pending) {
+  pending.active = false;
+  this->vehicle_count_++;
+
+  const FusedEvent &fused = pending.fused;
+  ESP_LOGD(TAG, "Vehicle: lane %u, max %d.%d, %u radars", fused.lane, fused.event.max_speed / 10,
+           fused.event.max_speed % 10, fused.radar_count);
+
+  this->vehicle_callback_.call(fused);
+
+#ifdef USE_SENSOR
+  if (this->vehicle_count_sensor_ != nullptr)
+    this->vehicle_count_sensor_->publish_state(this->vehicle_count_);
+  if (this->vehicle_speed_sensor_ != nullptr)
+    this->vehicle_speed_sensor_->publish_state(ld2415h::speed_to_float(fused.event.max_speed));
+  if (this->vehicle_lane_sensor_ != nullptr)
+    this->vehicle_lane_sensor_->publish_state(fused.lane);
+  if (this->duplicates_sensor_ != nullptr)
+    this->duplicates_sensor_->publish_state(this->duplicates_);
+#endif
+}
+
+}  // namespace ld2415h_hub
+}  // namespace esphome
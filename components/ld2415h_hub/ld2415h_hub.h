@@ -0,0 +1,95 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/components/ld2415h/ld2415h.h"
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
+#include <array>
+#include <cstdlib>
+
+namespace esphome {
+namespace ld2415h_hub {
+
+using ld2415h::Direction;
+using ld2415h::LD2415HComponent;
+using ld2415h::LD2415HListener;
+using ld2415h::VehicleEvent;
+
+static const uint8_t MAX_RADARS = 4;
+static const uint8_t MAX_PENDING_EVENTS = 4;
+
+// One vehicle after merging the detections of all radars that saw it
+struct FusedEvent {
+  VehicleEvent event;
+  uint8_t lane;
+  uint8_t radar_count;
+};
+
+class LD2415HHub;
+
+// Registered on a single radar, tagging its events with the radar index
+class LD2415HHubInput : public LD2415HListener {
+ public:
+  void on_vehicle_event(const VehicleEvent &event) override;
+
+  LD2415HHub *hub{nullptr};
+  uint8_t index{0};
+  uint8_t lane{0};
+  int32_t time_offset{0};
+};
+
+class LD2415HHub : public Component {
+ public:
+  void loop() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  void add_radar(LD2415HComponent *radar, uint8_t lane, int32_t time_offset);
+  void set_window(uint32_t window) { this->window_ = window; }
+  void set_speed_tolerance(float tolerance) { this->speed_tolerance_ = tolerance * 10; }
+  void add_on_vehicle_callback(std::function<void(FusedEvent)> &&callback) {
+    this->vehicle_callback_.add(std::move(callback));
+  }
+#ifdef USE_SENSOR
+  void set_vehicle_count_sensor(sensor::Sensor *sensor) { this->vehicle_count_sensor_ = sensor; }
+  void set_vehicle_speed_sensor(sensor::Sensor *sensor) { this->vehicle_speed_sensor_ = sensor; }
+  void set_vehicle_lane_sensor(sensor::Sensor *sensor) { this->vehicle_lane_sensor_ = sensor; }
+  void set_duplicates_sensor(sensor::Sensor *sensor) { this->duplicates_sensor_ = sensor; }
+#endif
+
+  void on_radar_event(const LD2415HHubInput &input, const VehicleEvent &event);
+
+ protected:
+  struct PendingEvent {
+    bool active;
+    uint32_t received;         // millis() when the first detection arrived
+    uint32_t start;            // Aligned start of the first detection
+    uint8_t radar_mask;
+    uint16_t lane_frames;      // Frames from the radar that decided the lane
+    FusedEvent fused;
+  };
+
+  void emit_(PendingEvent &pending);
+
+  std::array<LD2415HHubInput, MAX_RADARS> inputs_{};
+  uint8_t radar_count_{0};
+  std::array<PendingEvent, MAX_PENDING_EVENTS> pending_{};
+
+  uint32_t window_{1000};
+  ld2415h::speed_t speed_tolerance_{50};
+  uint32_t vehicle_count_{0};
+  uint32_t duplicates_{0};
+  CallbackManager<void(FusedEvent)> vehicle_callback_;
+
+#ifdef USE_SENSOR
+  sensor::Sensor *vehicle_count_sensor_{nullptr};
+  sensor::Sensor *vehicle_speed_sensor_{nullptr};
+  sensor::Sensor *vehicle_lane_sensor_{nullptr};
+  sensor::Sensor *duplicates_sensor_{nullptr};
+#endif
+};
+
+}  // namespace ld2415h_hub
+}  // namespace esphome
@@ -0,0 +1,72 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import (
+    DEVICE_CLASS_SPEED,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_EMPTY,
+    UNIT_KILOMETER_PER_HOUR,
+)
+from .. import CONF_LD2415H_HUB_ID, LD2415HHub
+
+CONF_VEHICLE_COUNT = "vehicle_count"
+CONF_VEHICLE_SPEED = "vehicle_speed"
+CONF_VEHICLE_LANE = "vehicle_lane"
+CONF_DUPLICATES = "duplicates"
+
+ICON_CAR = "mdi:car"
+ICON_ROAD = "mdi:road-variant"
+ICON_COUNTER = "mdi:counter"
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(CONF_LD2415H_HUB_ID): cv.use_id(LD2415HHub),
+        cv.Optional(CONF_VEHICLE_COUNT): sensor.sensor_schema(
+            unit_of_measurement=UNIT_EMPTY,
+            icon=ICON_CAR,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+        ),
+        cv.Optional(CONF_VEHICLE_SPEED): sensor.sensor_schema(
+            device_class=DEVICE_CLASS_SPEED,
+            state_class=STATE_CLASS_MEASUREMENT,
+            unit_of_measurement=UNIT_KILOMETER_PER_HOUR,
+            icon=ICON_CAR,
+            accuracy_decimals=1,
+        ),
+        cv.Optional(CONF_VEHICLE_LANE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_EMPTY,
+            icon=ICON_ROAD,
+            accuracy_decimals=0,
+        ),
+        cv.Optional(CONF_DUPLICATES): sensor.sensor_schema(
+            unit_of_measurement=UNIT_EMPTY,
+            icon=ICON_COUNTER,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+)
+
+
+async def to_code(config):
+    hub = await cg.get_variable(config[CONF_LD2415H_HUB_ID])
+
+    if vehicle_count := config.get(CONF_VEHICLE_COUNT):
+        sens = await sensor.new_sensor(vehicle_count)
+        cg.add(hub.set_vehicle_count_sensor(sens))
+
+    if vehicle_speed := config.get(CONF_VEHICLE_SPEED):
+        sens = await sensor.new_sensor(vehicle_speed)
+        cg.add(hub.set_vehicle_speed_sensor(sens))
+
+    if vehicle_lane := config.get(CONF_VEHICLE_LANE):
+        sens = await sensor.new_sensor(vehicle_lane)
+        cg.add(hub.set_vehicle_lane_sensor(sens))
+
+    if duplicates := config.get(CONF_DUPLICATES):
+        sens = await sensor.new_sensor(duplicates)
+        cg.add(hub.set_duplicates_sensor(sens))
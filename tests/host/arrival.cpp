@@ -0,0 +1,85 @@
+// Tests for the arrival estimator's handling of vehicle events from other
+// targets while it tracks an approaching one.
+
+#include <cmath>
+#include "esphome/components/ld2415h/sensor/arrival_estimator.h"
+#include "host.h"
+#include "test_util.h"
+
+using namespace esphome;
+using namespace esphome::ld2415h;
+
+class ArrivalFixture {
+ public:
+  ArrivalFixture() {
+    this->estimator.set_parent(&this->component);
+    this->estimator.set_distance_sensor(&this->distance);
+  }
+
+  // Approaching frames at 36 km/h every 100 ms from start_ms
+  void approach(uint32_t start_ms, int frames) {
+    for (int i = 0; i < frames; i++) {
+      Sample sample{};
+      sample.speed = 360;
+      sample.velocity = 360;
+      sample.direction = Direction::DIRECTION_APPROACHING;
+      sample.timestamp = start_ms + i * 100;
+      sample.timestamp_us = sample.timestamp * 1000;
+      this->estimator.on_sample(sample);
+    }
+  }
+
+  void event(Direction direction, uint32_t start_ms, uint32_t duration_ms) {
+    VehicleEvent event{};
+    event.max_speed = 360;
+    event.mean_speed = 360;
+    event.direction = direction;
+    event.start = start_ms;
+    event.duration = duration_ms;
+    event.frame_count = duration_ms / 100 + 1;
+    this->estimator.on_vehicle_event(event);
+  }
+
+  // Whether update() still publishes a distance for the target
+  bool tracking() {
+    this->estimator.update();
+    return !std::isnan(this->distance.state);
+  }
+
+  LD2415HComponent component;
+  ArrivalEstimator estimator;
+  sensor::Sensor distance{"distance"};
+};
+
+static void test_other_direction_ignored() {
+  ArrivalFixture fixture;
+  fixture.approach(10000, 5);
+  fixture.event(Direction::DIRECTION_RETREATING, 9800, 600);
+  CHECK(fixture.tracking());
+}
+
+static void test_earlier_vehicle_ignored() {
+  ArrivalFixture fixture;
+  fixture.approach(10000, 5);
+  // An approaching vehicle whose last frame came before this target's first
+  fixture.event(Direction::DIRECTION_APPROACHING, 7000, 2500);
+  CHECK(fixture.tracking());
+}
+
+static void test_own_event_resets() {
+  ArrivalFixture fixture;
+  fixture.approach(10000, 5);
+  fixture.event(Direction::DIRECTION_APPROACHING, 10000, 400);
+  CHECK(!fixture.tracking());
+
+  // The next target starts a new track
+  fixture.approach(20000, 3);
+  CHECK(fixture.tracking());
+}
+
+int main() {
+  test_other_direction_ignored();
+  test_earlier_vehicle_ignored();
+  test_own_event_resets();
+  return ld2415h_test::test_failures();
+}
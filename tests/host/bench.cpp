@@ -0,0 +1,183 @@
+// Cost of the UART read and parse path over fixed corpora, printed as JSON for
+// check_bench.py to compare with baselines/bench.json:
+//   clean   speed frames only
+//   noisy   speed frames separated by 0x00/0xFF line noise
+//   config  speed frames with bursts of configuration read-backs
+// For each corpus it reports ns/frame, heap allocations per frame and the peak
+// stack of the thread running loop(). Only loop() is measured; feeding the
+// stand-in UART is not. The figures are for the host build and compare
+// revisions; they do not predict the device.
+
+#include <pthread.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+#include "harness.h"
+
+using namespace ld2415h_test;
+
+static bool counting_allocations = false;
+static size_t allocations = 0;
+
+void *operator new(size_t size) {
+  if (counting_allocations)
+    allocations++;
+  void *p = std::malloc(size ? size : 1);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+class CountingListener : public LD2415HListener {
+ public:
+  void on_sample(const Sample &sample) override { this->samples++; }
+
+  size_t samples{0};
+};
+
+struct Corpus {
+  const char *name;
+  ByteStream block;
+  size_t frames;
+};
+
+struct Result {
+  double ns_per_frame;
+  double allocations_per_frame;
+  size_t peak_stack;
+};
+
+static const size_t ROUNDS = 5000;
+static const size_t STACK_SIZE = 256 * 1024;
+static const uint8_t STACK_PAINT = 0xA5;
+
+static std::vector<Corpus> corpora() {
+  std::vector<Corpus> corpora;
+
+  Corpus clean{"clean", ByteStream(), 0};
+  for (int i = 0; i < 64; i++, clean.frames++)
+    clean.block.speed((i * 37) % 1200 - 600);
+  corpora.push_back(clean);
+
+  Corpus noisy{"noisy", ByteStream(), 0};
+  for (int i = 0; i < 64; i++, noisy.frames++)
+    noisy.block.speed((i * 37) % 1200 - 600).noise(16);
+  corpora.push_back(noisy);
+
+  // A read-back burst, as when several entities change at once
+  Corpus config{"config", ByteStream(), 0};
+  for (int i = 0; i < 48; i++, config.frames++)
+    config.block.speed((i * 37) % 1200 - 600);
+  for (int i = 0; i < 16; i++, config.frames++)
+    config.block.line(Radar::default_config());
+  corpora.push_back(config);
+
+  return corpora;
+}
+
+struct BenchRun {
+  const Corpus *corpus;
+  LD2415HComponent *component;
+  Result result;
+};
+
+// The measured rounds, on the bench thread
+static void *run(void *arg) {
+  BenchRun *bench = static_cast<BenchRun *>(arg);
+  const auto &bytes = bench->corpus->block.bytes();
+
+  double ns = 0;
+  allocations = 0;
+  for (size_t round = 0; round < ROUNDS; round++) {
+    bench->component->inject(bytes.data(), bytes.size());
+    esphome::host::advance_us(LOOP_INTERVAL_US);
+    counting_allocations = true;
+    auto start = std::chrono::steady_clock::now();
+    bench->component->loop();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    counting_allocations = false;
+    ns += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  }
+
+  size_t frames = bench->corpus->frames * ROUNDS;
+  bench->result.ns_per_frame = ns / frames;
+  bench->result.allocations_per_frame = static_cast<double>(allocations) / frames;
+  return nullptr;
+}
+
+static void *idle(void *arg) { return nullptr; }
+
+// Runs fn on a thread whose stack is painted first, and returns how far down
+// the stack was written
+static size_t stack_use(void *(*fn)(void *), void *arg) {
+  std::vector<uint8_t> stack(STACK_SIZE, STACK_PAINT);
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstack(&attr, stack.data(), stack.size());
+  pthread_t thread;
+  if (pthread_create(&thread, &attr, fn, arg) != 0) {
+    std::fprintf(stderr, "Cannot start the bench thread\n");
+    std::exit(1);
+  }
+  pthread_join(thread, nullptr);
+  pthread_attr_destroy(&attr);
+
+  // The stack grows down from the end of the buffer
+  size_t untouched = 0;
+  while (untouched < stack.size() && stack[untouched] == STACK_PAINT)
+    untouched++;
+  return stack.size() - untouched;
+}
+
+// Sets the component up, then runs the rounds on a painted stack for the peak
+// stack use of loop() and what it calls
+static Result bench(const Corpus &corpus) {
+  esphome::host::clear_preferences();
+  auto component = std::make_unique<LD2415HComponent>();
+  CountingListener listener;
+  component->register_listener(&listener);
+  component->setup();
+  // Confirm the boot configuration so the measurement is not interleaved with retries
+  esphome::host::advance_us(LOOP_INTERVAL_US);
+  component->loop();
+  component->inject((Radar::default_config() + "\r\n").c_str());
+  esphome::host::advance_us(LOOP_INTERVAL_US);
+  component->loop();
+  if (component->is_config_pending()) {
+    std::fprintf(stderr, "%s: boot configuration not confirmed\n", corpus.name);
+    std::exit(1);
+  }
+
+  BenchRun bench{&corpus, component.get(), {}};
+  // glibc keeps the thread descriptor and TLS at the top of a supplied stack,
+  // so what an idle thread uses is taken off
+  bench.result.peak_stack = stack_use(run, &bench) - stack_use(idle, nullptr);
+  if (listener.samples == 0)
+    bench.result.ns_per_frame = -1;
+  return bench.result;
+}
+
+int main() {
+  std::printf("{\"build\":\"%s\",\"corpora\":{", LD2415H_BUILD_TYPE);
+  bool first = true;
+  for (const auto &corpus : corpora()) {
+    Result result = bench(corpus);
+    if (result.ns_per_frame < 0) {
+      std::fprintf(stderr, "%s: no samples decoded\n", corpus.name);
+      return 1;
+    }
+    std::printf("%s\"%s\":{\"frames\":%zu,\"bytes\":%zu,\"ns_per_frame\":%.1f,\"allocations_per_frame\":%.3f,"
+                "\"peak_stack\":%zu}",
+                first ? "" : ",", corpus.name, corpus.frames, corpus.block.bytes().size(), result.ns_per_frame,
+                result.allocations_per_frame, result.peak_stack);
+    first = false;
+  }
+  std::printf("}}\n");
+  return 0;
+}
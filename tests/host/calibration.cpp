@@ -0,0 +1,99 @@
+// Tests for calibration: the saved result is left alone at boot until it is
+// applied on request, the sweep starts at the most sensitive documented
+// setting, and scoring prefers the most sensitive quiet setting.
+
+#include "esphome/components/ld2415h/calibration.h"
+#include "esphome/components/ld2415h/fnv1a.h"
+#include "harness.h"
+#include "test_util.h"
+
+using namespace ld2415h_test;
+
+class ScoringCalibration : public Calibration {
+ public:
+  void keep(const CalibrationScore &score) { this->best_ = score; }
+  bool better(const CalibrationScore &score) const { return this->better_(score); }
+};
+
+// A radar that has confirmed its boot configuration and a saved calibration
+// result of sensitivity 3 and vibration correction 40
+class CalibrationFixture {
+ public:
+  CalibrationFixture() {
+    esphome::host::clear_preferences();
+    CalibrationResult result{3, 40, 0};
+    const uint8_t settings[2] = {result.sensitivity, result.vibration_correction};
+    result.hash = fnv1a_hash(settings, sizeof(settings));
+    auto pref = global_preferences->make_preference<CalibrationResult>(fnv1_hash("ld2415h_calibration_test"), true);
+    pref.save(&result);
+
+    this->radar.setup();
+    this->radar.play(ByteStream().pause(20).line(Radar::default_config()));
+
+    this->calibration.set_parent(&this->radar.component);
+    this->calibration.set_id("test");
+    this->calibration.setup();
+  }
+
+  Radar radar;
+  Calibration calibration;
+};
+
+static void test_saved_result_not_applied_at_boot() {
+  CalibrationFixture fixture;
+  CHECK_EQ(fixture.radar.component.get_sensitivity(), 10);
+  CHECK_EQ(fixture.radar.component.get_vibration_correction(), 18);
+  CHECK(!fixture.radar.component.is_config_pending());
+}
+
+static void test_apply() {
+  CalibrationFixture fixture;
+  fixture.calibration.apply();
+  CHECK_EQ(fixture.radar.component.get_sensitivity(), 3);
+  CHECK_EQ(fixture.radar.component.get_vibration_correction(), 40);
+  fixture.radar.play(ByteStream(), 100);
+  CHECK(fixture.radar.component.is_config_pending());
+}
+
+static void test_sweep_starts_at_one() {
+  CalibrationFixture fixture;
+  fixture.radar.component.written().clear();
+  fixture.calibration.start();
+  CHECK_EQ(fixture.radar.component.get_sensitivity(), 1);
+  fixture.radar.play(ByteStream(), 100);
+  const auto &written = fixture.radar.component.written();
+  CHECK(written.size() >= 6 && written[2] == CMD_SET_SPEED_ANGLE_SENSE && written[5] == 1);
+  fixture.calibration.cancel();
+}
+
+// Sensitivity 0 is not documented, so it is clamped to 1 before it is sent
+static void test_sensitivity_zero_clamped() {
+  CalibrationFixture fixture;
+  fixture.radar.component.written().clear();
+  fixture.radar.component.set_sensitivity(0);
+  fixture.radar.play(ByteStream(), 100);
+  const auto &written = fixture.radar.component.written();
+  CHECK(written.size() >= 6 && written[2] == CMD_SET_SPEED_ANGLE_SENSE && written[5] == 1);
+}
+
+static void test_most_sensitive_quiet_setting() {
+  ScoringCalibration calibration;
+  calibration.keep({1, 2, 0, true});
+  // Passing traffic during the sweep does not make a setting better
+  CHECK(!calibration.better({3, 0, 8, true}));
+  CHECK(!calibration.better({3, 2, 0, false}));
+
+  calibration.keep({1, 40, 0, false});
+  CHECK(calibration.better({3, 2, 0, true}));
+  CHECK(calibration.better({3, 20, 0, false}));
+  CHECK(!calibration.better({3, 60, 9, false}));
+}
+
+int main() {
+  test_saved_result_not_applied_at_boot();
+  test_apply();
+  test_sweep_starts_at_one();
+  test_sensitivity_zero_clamped();
+  test_most_sensitive_quiet_setting();
+  return ld2415h_test::test_failures();
+}
@@ -0,0 +1,77 @@
+"""Runs the bench host binary and compares its figures with a baseline.
+
+    check_bench.py <bench binary> <baseline.json> [--update]
+
+Allocations per frame must not rise at all. Peak stack and ns/frame get some
+headroom for compiler and machine differences, and are only compared when the
+build type matches the baseline's. --update rewrites the baseline from this
+run instead.
+"""
+
+import json
+from pathlib import Path
+import subprocess
+import sys
+
+# Allowed growth over the baseline
+STACK_FACTOR = 1.25
+STACK_SLACK = 256
+NS_FACTOR = 3.0
+
+
+def check(result, baseline):
+    failures = []
+    same_build = result["build"] == baseline["build"]
+    if not same_build:
+        print(
+            f"note: {result['build']} build against a {baseline['build']} baseline, "
+            "checking allocations only"
+        )
+
+    for name, expected in baseline["corpora"].items():
+        actual = result["corpora"].get(name)
+        if actual is None:
+            failures.append(f"{name}: missing from the bench output")
+            continue
+        print(
+            f"{name}: {actual['ns_per_frame']} ns/frame "
+            f"(baseline {expected['ns_per_frame']}), "
+            f"{actual['allocations_per_frame']} allocations/frame "
+            f"(baseline {expected['allocations_per_frame']}), "
+            f"{actual['peak_stack']} B stack (baseline {expected['peak_stack']})"
+        )
+        if actual["frames"] != expected["frames"] or actual["bytes"] != expected["bytes"]:
+            failures.append(f"{name}: corpus differs from the baseline, rerun with --update")
+        if actual["allocations_per_frame"] > expected["allocations_per_frame"]:
+            failures.append(f"{name}: allocations per frame rose")
+        if not same_build:
+            continue
+        if actual["peak_stack"] > expected["peak_stack"] * STACK_FACTOR + STACK_SLACK:
+            failures.append(f"{name}: peak stack rose")
+        if actual["ns_per_frame"] > expected["ns_per_frame"] * NS_FACTOR:
+            failures.append(f"{name}: ns/frame rose")
+    return failures
+
+
+def main(argv):
+    if len(argv) not in (3, 4) or (len(argv) == 4 and argv[3] != "--update"):
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+
+    output = subprocess.run([argv[1]], check=True, capture_output=True, text=True).stdout
+    result = json.loads(output)
+    baseline_path = Path(argv[2])
+
+    if len(argv) == 4:
+        baseline_path.write_text(json.dumps(result, indent=2) + "\n")
+        print(f"wrote {baseline_path}")
+        return 0
+
+    failures = check(result, json.loads(baseline_path.read_text()))
+    for failure in failures:
+        print(f"FAIL {failure}")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
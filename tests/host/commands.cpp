@@ -0,0 +1,174 @@
+// Tests for the command path: when millis() is past 2^31 ms, about 24.8 days of
+// uptime, and when it wraps, queued commands, retries with backoff and the
+// debounce hold must all still go out; the boot read-back that checks a
+// cached configuration is retried when the sensor does not answer; and the
+// sample rate governor does not rewrite the cached configuration.
+
+#include "harness.h"
+#include "test_util.h"
+
+using namespace ld2415h_test;
+
+// 2^31 ms, when a signed difference against an early timestamp turns negative
+static const uint64_t HALF_WRAP_US = (1ULL << 31) * 1000;
+static const uint64_t WRAP_US = (1ULL << 32) * 1000;
+
+// Number of times the set command was written
+static size_t writes_of(Radar &radar, CommandId id) {
+  const auto &written = radar.component.written();
+  size_t count = 0;
+  for (size_t i = 0; i + 2 < written.size(); i++) {
+    if (written[i] == 0x43 && written[i + 1] == 0x46 && written[i + 2] == id)
+      count++;
+  }
+  return count;
+}
+
+class CommandFixture {
+ public:
+  CommandFixture(uint64_t start_us, uint32_t debounce = 0) {
+    esphome::host::clear_preferences();
+    esphome::host::set_time_us(start_us);
+    this->radar.component.set_config_debounce(debounce);
+    this->radar.setup();
+    this->radar.play(ByteStream().pause(20).line(Radar::default_config()));
+    this->radar.component.written().clear();
+  }
+
+  Radar radar;
+};
+
+static void test_boot_after_half_wrap() {
+  CommandFixture fixture(HALF_WRAP_US + 5000000);
+  CHECK(!fixture.radar.component.is_config_pending());
+}
+
+static void test_change_after_half_wrap() {
+  CommandFixture fixture(HALF_WRAP_US + 5000000);
+  fixture.radar.sensitivity.make_call().set_value(5).perform();
+  fixture.radar.play(ByteStream().pause(100));
+  CHECK_EQ(writes_of(fixture.radar, CMD_SET_SPEED_ANGLE_SENSE), 1u);
+}
+
+static void test_retry_across_wrap() {
+  // The read-back times out just before millis() wraps, so the backoff runs
+  // across it
+  CommandFixture fixture(WRAP_US - 1100000);
+  fixture.radar.sensitivity.make_call().set_value(5).perform();
+  fixture.radar.play(ByteStream().pause(3000));
+  CHECK(writes_of(fixture.radar, CMD_SET_SPEED_ANGLE_SENSE) >= 2);
+}
+
+static void test_debounce_after_half_wrap() {
+  CommandFixture fixture(HALF_WRAP_US + 5000000, 300);
+  fixture.radar.sensitivity.make_call().set_value(5).perform();
+  fixture.radar.play(ByteStream().pause(100));
+  CHECK_EQ(writes_of(fixture.radar, CMD_SET_SPEED_ANGLE_SENSE), 0u);
+  fixture.radar.play(ByteStream().pause(300));
+  CHECK_EQ(writes_of(fixture.radar, CMD_SET_SPEED_ANGLE_SENSE), 1u);
+}
+
+// A radar booting with the configuration cached by an earlier boot
+class CachedBootFixture {
+ public:
+  CachedBootFixture() {
+    esphome::host::clear_preferences();
+    esphome::host::set_time_us(1000000);
+    {
+      Radar first;
+      first.component.set_config_cache("radar");
+      first.setup();
+      first.play(ByteStream().pause(20).line(Radar::default_config()));
+    }
+    this->radar.component.set_config_cache("radar");
+    this->radar.setup();
+  }
+
+  Radar radar;
+};
+
+static void test_cached_boot_read_retried() {
+  CachedBootFixture fixture;
+  // The sensor is still booting and misses the first read
+  fixture.radar.play(ByteStream().pause(1600));
+  CHECK_EQ(writes_of(fixture.radar, CMD_GET_CONFIG), 2u);
+  CHECK_EQ(writes_of(fixture.radar, CMD_SET_SPEED_ANGLE_SENSE), 0u);
+
+  // The answer to the retry shows a sensor that differs from the cache
+  fixture.radar.play(ByteStream().line("X1:01 X2:00 X3:05 X4:00 X5:01 X6:00 X7:12 X8:00 X9:01 X0:01"), 500);
+  CHECK_EQ(writes_of(fixture.radar, CMD_SET_SPEED_ANGLE_SENSE), 1u);
+}
+
+static void test_cached_boot_without_answer() {
+  CachedBootFixture fixture;
+  fixture.radar.play(ByteStream().pause(9000));
+  // Every read timed out, so the whole configuration is sent
+  CHECK_EQ(writes_of(fixture.radar, CMD_GET_CONFIG), static_cast<size_t>(COMMAND_MAX_ATTEMPTS + 1));
+  CHECK_EQ(writes_of(fixture.radar, CMD_SET_SPEED_ANGLE_SENSE), 1u);
+  CHECK_EQ(writes_of(fixture.radar, CMD_SET_ANTI_VIB_COMP), 1u);
+}
+
+// Answers each configuration read with the defaults and the sample rate last
+// written, as the sensor would
+static void answer_reads(Radar &radar, size_t &answered) {
+  size_t reads = writes_of(radar, CMD_GET_CONFIG);
+  if (reads == answered)
+    return;
+  answered = reads;
+
+  const auto &written = radar.component.written();
+  uint8_t rate = 1;
+  for (size_t i = 0; i + 4 < written.size(); i++) {
+    if (written[i] == 0x43 && written[i + 1] == 0x46 && written[i + 2] == CMD_SET_MODE_RATE_UOM)
+      rate = written[i + 4];
+  }
+  char line[96];
+  snprintf(line, sizeof(line), "X1:01 X2:00 X3:0a X4:00 X5:%02x X6:00 X7:12 X8:00 X9:01 X0:01\r\n", rate);
+  radar.component.inject(line);
+}
+
+static void test_governor_keeps_cache() {
+  esphome::host::clear_preferences();
+  esphome::host::set_time_us(1000000);
+  Radar radar;
+  radar.component.set_config_cache("radar");
+  radar.component.set_sample_rate_governor(0, 2, 1000, 3);
+  radar.setup();
+
+  size_t answered = 0;
+  for (int i = 0; i < 5; i++) {
+    radar.play(ByteStream().pause(100));
+    answer_reads(radar, answered);
+  }
+  CHECK(!radar.component.is_config_pending());
+  uint32_t writes = esphome::host::preference_writes();
+
+  // Traffic and quiet in turn, each switching the rate
+  for (int cycle = 0; cycle < 3; cycle++) {
+    for (int i = 0; i < 10; i++) {
+      ByteStream traffic;
+      traffic.speed(300);
+      radar.play(traffic);
+      answer_reads(radar, answered);
+    }
+    for (int i = 0; i < 25; i++) {
+      radar.play(ByteStream().pause(100));
+      answer_reads(radar, answered);
+    }
+  }
+
+  CHECK(writes_of(radar, CMD_SET_MODE_RATE_UOM) >= 7);
+  CHECK(!radar.component.is_config_pending());
+  CHECK_EQ(esphome::host::preference_writes(), writes);
+}
+
+int main() {
+  test_boot_after_half_wrap();
+  test_change_after_half_wrap();
+  test_retry_across_wrap();
+  test_debounce_after_half_wrap();
+  test_cached_boot_read_retried();
+  test_cached_boot_without_answer();
+  test_governor_keeps_cache();
+  return ld2415h_test::test_failures();
+}
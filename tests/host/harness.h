@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "esphome/components/ld2415h/ld2415h.h"
+#include "esphome/components/ld2415h/number/sensitivity_number.h"
+#include "esphome/components/ld2415h/select/sample_rate_select.h"
+#include "esphome/components/ld2415h/sensor/ld2415h_sensor.h"
+#include "host.h"
+
+namespace ld2415h_test {
+
+using namespace esphome;
+using namespace esphome::ld2415h;
+
+// 9600 baud, 8N1
+static const uint32_t BYTE_TIME_US = 10 * 1000000 / 9600;
+// ESPHome runs loop() about every 16 ms
+static const uint32_t LOOP_INTERVAL_US = 16000;
+// Frame period at the default ~11 fps
+static const uint32_t FRAME_PERIOD_US = 1000000 / 11;
+
+// Sensor output as it appears on the wire, with the time each byte arrives
+class ByteStream {
+ public:
+  explicit ByteStream(uint32_t frame_period_us = FRAME_PERIOD_US) : frame_period_us_(frame_period_us) {}
+
+  // One speed frame in tenths, negative when retreating, at the next frame slot
+  ByteStream &speed(int tenths) {
+    char frame[16];
+    int value = tenths < 0 ? -tenths : tenths;
+    snprintf(frame, sizeof(frame), "V%c%03d.%d\r\n", tenths < 0 ? '-' : '+', value / 10, value % 10);
+    return this->frame(frame);
+  }
+
+  // A text line such as a configuration read-back, at the next frame slot
+  ByteStream &line(const std::string &text) { return this->frame(text + "\r\n"); }
+
+  // Raw bytes at the next frame slot
+  ByteStream &frame(const std::string &bytes) {
+    return this->frame(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size());
+  }
+  ByteStream &frame(const uint8_t *data, size_t len) {
+    if (this->slot_us_ < this->cursor_us_)
+      this->slot_us_ = this->cursor_us_;
+    this->cursor_us_ = this->slot_us_;
+    this->append_(data, len);
+    this->slot_us_ += this->frame_period_us_;
+    return *this;
+  }
+
+  // 0x00/0xFF line noise straight after the previous bytes
+  ByteStream &noise(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      uint8_t c = (i & 1) ? 0xFF : 0x00;
+      this->append_(&c, 1);
+    }
+    return *this;
+  }
+
+  // Silence on the line
+  ByteStream &pause(uint32_t ms) {
+    this->slot_us_ += static_cast<uint64_t>(ms) * 1000;
+    return *this;
+  }
+
+  const std::vector<uint8_t> &bytes() const { return this->bytes_; }
+  const std::vector<uint64_t> &times() const { return this->times_; }
+  uint64_t duration_us() const { return std::max(this->cursor_us_, this->slot_us_); }
+
+ protected:
+  void append_(const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      this->bytes_.push_back(data[i]);
+      this->times_.push_back(this->cursor_us_);
+      this->cursor_us_ += BYTE_TIME_US;
+    }
+  }
+
+  uint32_t frame_period_us_;
+  uint64_t slot_us_{0};
+  uint64_t cursor_us_{0};
+  std::vector<uint8_t> bytes_;
+  std::vector<uint64_t> times_;
+};
+
+// The component with the sensor platform and a number and select entity, as a
+// typical YAML configuration would create them
+class Radar {
+ public:
+  Radar() {
+    this->component.set_diagnostics_interval(1000);
+    this->component.set_parse_failures_sensor(&this->parse_failures);
+    this->component.set_unknown_frames_sensor(&this->unknown_frames);
+    this->component.set_buffer_overruns_sensor(&this->buffer_overruns);
+    this->component.set_dropped_frames_sensor(&this->dropped_frames);
+
+    this->platform.set_speed_sensor(&this->speed);
+    this->platform.set_velocity_sensor(&this->velocity);
+    this->platform.set_vehicle_count_sensor(&this->vehicle_count);
+    this->component.register_listener(&this->platform);
+
+    this->sensitivity.set_parent(&this->component);
+    this->component.set_sensitivity_number(&this->sensitivity);
+    this->sample_rate.set_parent(&this->component);
+    this->component.set_sample_rate_select(&this->sample_rate);
+  }
+
+  void setup() {
+    this->component.setup();
+    this->platform.call_setup();
+  }
+
+  // One pass of the ESPHome main loop
+  void loop() {
+    this->component.loop();
+    this->platform.loop();
+    esphome::host::run_scheduler();
+  }
+
+  // Deliver the stream at line rate starting now, running loop() at the
+  // loop interval, then keep looping for the tail
+  void play(const ByteStream &stream, uint32_t tail_ms = 0) {
+    uint64_t start = esphome::host::now_us();
+    size_t next = 0;
+    const auto &bytes = stream.bytes();
+    const auto &times = stream.times();
+    uint64_t end = start + stream.duration_us() + static_cast<uint64_t>(tail_ms) * 1000;
+
+    while (esphome::host::now_us() < end || next < bytes.size()) {
+      esphome::host::advance_us(LOOP_INTERVAL_US);
+      uint64_t now = esphome::host::now_us();
+      size_t first = next;
+      while (next < bytes.size() && start + times[next] <= now)
+        next++;
+      if (next > first)
+        this->component.inject(bytes.data() + first, next - first);
+      this->loop();
+    }
+  }
+
+  // The configuration read-back matching the component defaults
+  static std::string default_config() { return "X1:01 X2:00 X3:0a X4:00 X5:01 X6:00 X7:12 X8:00 X9:01 X0:01"; }
+
+  LD2415HComponent component;
+  LD2415HSensor platform;
+  sensor::Sensor speed{"speed"};
+  sensor::Sensor velocity{"velocity"};
+  sensor::Sensor vehicle_count{"vehicle_count"};
+  sensor::Sensor parse_failures{"parse_failures"};
+  sensor::Sensor unknown_frames{"unknown_frames"};
+  sensor::Sensor buffer_overruns{"buffer_overruns"};
+  sensor::Sensor dropped_frames{"dropped_frames"};
+  SensitivityNumber sensitivity;
+  SampleRateSelect sample_rate;
+};
+
+}  // namespace ld2415h_test
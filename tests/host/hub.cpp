@@ -0,0 +1,126 @@
+// Tests for fusing the vehicle events of several radars in ld2415h_hub.
+
+#include <vector>
+#include "esphome/components/ld2415h_hub/ld2415h_hub.h"
+#include "host.h"
+#include "test_util.h"
+
+using namespace esphome;
+using namespace esphome::ld2415h_hub;
+
+class HubFixture {
+ public:
+  HubFixture(uint32_t window, float speed_tolerance) {
+    esphome::host::set_time_us(1000000);
+    this->hub.set_window(window);
+    this->hub.set_speed_tolerance(speed_tolerance);
+    this->hub.add_on_vehicle_callback([this](FusedEvent event) { this->fused.push_back(event); });
+  }
+
+  // An approaching vehicle from the given radar input, starting at start ms
+  void event(LD2415HHubInput &input, uint32_t start, ld2415h::speed_t max_speed) {
+    VehicleEvent event{};
+    event.max_speed = max_speed;
+    event.mean_speed = max_speed;
+    event.direction = Direction::DIRECTION_APPROACHING;
+    event.start = start;
+    event.duration = 500;
+    event.frame_count = 5;
+    this->hub.on_radar_event(input, event);
+  }
+
+  // Lets every pending vehicle age past the window
+  void flush() {
+    esphome::host::advance_us(10000000);
+    this->hub.loop();
+  }
+
+  // Radars that saw the fused vehicle with this maximum speed, 0 if none
+  uint8_t radar_count(ld2415h::speed_t max_speed) const {
+    for (const auto &event : this->fused) {
+      if (event.event.max_speed == max_speed)
+        return event.radar_count;
+    }
+    return 0;
+  }
+
+  LD2415HHubInput input(uint8_t index, int32_t time_offset) {
+    LD2415HHubInput input;
+    input.hub = &this->hub;
+    input.index = index;
+    input.lane = index + 1;
+    input.time_offset = time_offset;
+    return input;
+  }
+
+  LD2415HHub hub;
+  std::vector<FusedEvent> fused;
+};
+
+static void test_closest_candidate() {
+  HubFixture fixture(1000, 5.0f);
+  auto first = fixture.input(0, 0);
+  auto second = fixture.input(1, 0);
+
+  // Two vehicles close together on the first radar; the second radar's
+  // detection is within tolerance of both but much closer to the earlier one
+  fixture.event(first, 10000, 500);
+  fixture.event(first, 10300, 520);
+  fixture.event(second, 10010, 502);
+  fixture.flush();
+
+  CHECK_EQ(fixture.fused.size(), 2u);
+  CHECK_EQ(fixture.radar_count(502), 2);
+  CHECK_EQ(fixture.radar_count(520), 1);
+}
+
+static void test_speed_error_breaks_ties() {
+  HubFixture fixture(1000, 5.0f);
+  auto first = fixture.input(0, 0);
+  auto second = fixture.input(1, 0);
+
+  // Equal time error, so the smaller speed error decides
+  fixture.event(first, 10000, 480);
+  fixture.event(first, 10200, 520);
+  fixture.event(second, 10100, 485);
+  fixture.flush();
+
+  CHECK_EQ(fixture.fused.size(), 2u);
+  CHECK_EQ(fixture.radar_count(485), 2);
+  CHECK_EQ(fixture.radar_count(520), 1);
+}
+
+static void test_negative_time_offset() {
+  HubFixture fixture(200, 5.0f);
+  auto first = fixture.input(0, 0);
+  // The second beam sees vehicles 800 ms before the first
+  auto second = fixture.input(1, -800);
+
+  fixture.event(first, 10000, 500);
+  fixture.event(second, 9200, 505);
+  fixture.flush();
+
+  CHECK_EQ(fixture.fused.size(), 1u);
+  CHECK_EQ(fixture.radar_count(505), 2);
+}
+
+static void test_outside_tolerance() {
+  HubFixture fixture(1000, 5.0f);
+  auto first = fixture.input(0, 0);
+  auto second = fixture.input(1, 0);
+
+  fixture.event(first, 10000, 500);
+  fixture.event(second, 10100, 560);
+  fixture.event(second, 11500, 500);
+  fixture.flush();
+
+  CHECK_EQ(fixture.fused.size(), 3u);
+}
+
+int main() {
+  test_closest_candidate();
+  test_speed_error_breaks_ties();
+  test_negative_time_offset();
+  test_outside_tolerance();
+  return ld2415h_test::test_failures();
+}
@@ -0,0 +1,168 @@
+// Compares the incremental parser with the line parser it replaced, which
+// buffered a whole line and then decoded it with strtod(), strtok() and
+// std::stoi(). Both see the same bytes and hand each decoded value to a
+// listener; the component is driven through loop() so its figure includes the
+// UART read path.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "harness.h"
+
+using namespace ld2415h_test;
+
+// The original fill_buffer_() and parse_*_() logic, with entity publishing
+// replaced by the listener calls
+class LegacyParser {
+ public:
+  void feed(const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      if (this->fill_buffer_(data[i]))
+        this->parse_buffer_();
+    }
+  }
+
+  size_t samples{0};
+  size_t config_params{0};
+  double checksum{0};
+
+ protected:
+  void clear_remaining_buffer_(uint8_t pos) {
+    while (pos < sizeof(this->response_buffer_)) {
+      this->response_buffer_[pos] = 0x00;
+      pos++;
+    }
+    this->response_buffer_index_ = 0;
+  }
+
+  bool fill_buffer_(char c) {
+    switch (c) {
+      case 0x00:
+      case static_cast<char>(0xFF):
+      case '\r':
+        break;
+      case '\n':
+        if (this->response_buffer_index_ == 0)
+          break;
+        this->clear_remaining_buffer_(this->response_buffer_index_);
+        return true;
+      default:
+        this->response_buffer_[this->response_buffer_index_] = c;
+        this->response_buffer_index_++;
+        break;
+    }
+    return false;
+  }
+
+  void parse_buffer_() {
+    switch (this->response_buffer_[0]) {
+      case 'X':
+        this->parse_config_();
+        break;
+      case 'V':
+        this->parse_speed_();
+        break;
+      default:
+        break;
+    }
+    this->response_buffer_index_ = 0;
+  }
+
+  void parse_config_() {
+    const char *delim = ": ";
+    char *token = strtok(this->response_buffer_, delim);
+    while (token != nullptr) {
+      if (std::strlen(token) != 2)
+        break;
+      char *key = token;
+      token = strtok(nullptr, delim);
+      if (token == nullptr || std::strlen(token) != 2)
+        break;
+      this->parse_config_param_(key, token);
+      token = strtok(nullptr, delim);
+    }
+  }
+
+  void parse_config_param_(char *key, char *value) {
+    if (std::strlen(key) != 2 || std::strlen(value) != 2 || key[0] != 'X')
+      return;
+    this->checksum += std::stoi(value, nullptr, 16);
+    this->config_params++;
+  }
+
+  void parse_speed_() {
+    const char *p = strchr(this->response_buffer_, 'V');
+    if (p == nullptr)
+      return;
+    ++p;
+    double velocity = strtod(p, nullptr);
+    ++p;
+    double speed = strtod(p, nullptr);
+    this->checksum += velocity + speed;
+    this->samples++;
+  }
+
+  char response_buffer_[64];
+  uint8_t response_buffer_index_{0};
+};
+
+class CountingListener : public LD2415HListener {
+ public:
+  void on_sample(const Sample &sample) override {
+    this->samples++;
+    this->checksum += sample.velocity + sample.speed;
+  }
+
+  size_t samples{0};
+  double checksum{0};
+};
+
+static const size_t ROUNDS = 20000;
+
+int main() {
+  // 64 speed frames with a configuration read-back, as when an entity changes
+  ByteStream block;
+  size_t frames = 0;
+  for (int i = 0; i < 64; i++, frames++)
+    block.speed((i * 37) % 1200 - 600);
+  block.line(Radar::default_config());
+  frames++;
+  const auto &bytes = block.bytes();
+
+  LegacyParser legacy;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < ROUNDS; round++)
+    legacy.feed(bytes.data(), bytes.size());
+  double legacy_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  esphome::host::clear_preferences();
+  LD2415HComponent component;
+  CountingListener listener;
+  component.register_listener(&listener);
+  component.setup();
+  start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < ROUNDS; round++) {
+    component.inject(bytes.data(), bytes.size());
+    esphome::host::advance_us(LOOP_INTERVAL_US);
+    component.loop();
+  }
+  double current_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  if (legacy.samples != listener.samples || legacy.samples != 64 * ROUNDS) {
+    std::printf("Sample counts differ: legacy %zu, current %zu\n", legacy.samples, listener.samples);
+    return 1;
+  }
+  if (legacy.checksum == 0 || listener.checksum == 0)
+    return 1;
+
+  legacy_ns /= frames * ROUNDS;
+  current_ns /= frames * ROUNDS;
+  std::printf("legacy  (strtod/strtok/stoi) %.1f ns/frame\n", legacy_ns);
+  std::printf("current (incremental)        %.1f ns/frame\n", current_ns);
+  std::printf("speedup                      %.2fx\n", legacy_ns / current_ns);
+  return 0;
+}
@@ -0,0 +1,146 @@
+// Replays sensor output through LD2415HComponent::loop() on the host.
+//
+//   replay                 run the synthetic scenario, check the published
+//                          values, then measure ns/frame
+//   replay capture.bin     replay a raw capture of the sensor UART, e.g. from
+//                          `cat /dev/ttyUSB0 > capture.bin`, and report what
+//                          was decoded and ns/frame
+//
+// Bytes are delivered at 9600 baud with loop() every 16 ms, as on the device.
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include "harness.h"
+#include "test_util.h"
+
+using namespace ld2415h_test;
+
+static void check_scenario() {
+  esphome::host::clear_preferences();
+  Radar radar;
+  radar.setup();
+
+  ByteStream stream;
+  stream.line("No.:20230801E v5.0");
+  stream.line(Radar::default_config());
+  stream.noise(6);
+  // An approaching vehicle, then a retreating one after a gap
+  for (int tenths : {19, 125, 257, 384, 412})
+    stream.speed(tenths);
+  stream.noise(3).pause(1500);
+  for (int tenths : {-80, -95, -101})
+    stream.speed(tenths);
+  // Malformed frames: bad sign, too many digits, missing fraction
+  stream.line("V*001.9").line("V+0001.9").line("V+001.");
+  stream.line("Q");
+  radar.play(stream, 2000);
+
+  std::vector<float> expected_speed{1.9f, 12.5f, 25.7f, 38.4f, 41.2f, 8.0f, 9.5f, 10.1f};
+  CHECK_EQ(radar.speed.history().size(), expected_speed.size());
+  for (size_t i = 0; i < expected_speed.size() && i < radar.speed.history().size(); i++)
+    CHECK_NEAR(radar.speed.history()[i], expected_speed[i], 1e-4);
+  CHECK_NEAR(radar.velocity.state, -10.1, 1e-4);
+  CHECK_EQ(radar.vehicle_count.state, 2.0f);
+  CHECK_EQ(radar.parse_failures.state, 3.0f);
+  CHECK_EQ(radar.unknown_frames.state, 1.0f);
+  CHECK_EQ(radar.buffer_overruns.state, 0.0f);
+
+  // The read-back matched the configuration, so the entities hold it
+  CHECK_EQ(radar.sensitivity.state, 10.0f);
+  CHECK(radar.sample_rate.state == "~11 fps");
+  CHECK(!radar.component.is_config_pending());
+
+  // A change from the entity is written and confirmed by the next read-back
+  radar.component.written().clear();
+  radar.sensitivity.make_call().set_value(5).perform();
+  radar.play(ByteStream().pause(100));
+  const auto &written = radar.component.written();
+  CHECK(written.size() >= 8 && written[0] == 0x43 && written[1] == 0x46 && written[2] == CMD_SET_SPEED_ANGLE_SENSE &&
+        written[5] == 5);
+  CHECK(radar.component.is_config_pending());
+  radar.play(ByteStream().line("X1:01 X2:00 X3:05 X4:00 X5:01 X6:00 X7:12 X8:00 X9:01 X0:01"));
+  CHECK(!radar.component.is_config_pending());
+}
+
+// The deadband is rounded to the nearest tenth, not truncated, so 0.29
+// suppresses a change of 0.3
+static void check_deadband() {
+  esphome::host::clear_preferences();
+  Radar radar;
+  radar.platform.set_deadband(0.29f);
+  radar.setup();
+
+  ByteStream stream;
+  stream.line(Radar::default_config());
+  for (int tenths : {100, 103, 97, 115})
+    stream.speed(tenths);
+  radar.play(stream, 100);
+
+  std::vector<float> expected_speed{10.0f, 11.5f};
+  CHECK_EQ(radar.speed.history().size(), expected_speed.size());
+  for (size_t i = 0; i < expected_speed.size() && i < radar.speed.history().size(); i++)
+    CHECK_NEAR(radar.speed.history()[i], expected_speed[i], 1e-4);
+}
+
+// Feeds frames as fast as loop() takes them and reports the cost per frame
+static double measure(const std::vector<uint8_t> &block, size_t frames_per_block, size_t rounds) {
+  Radar radar;
+  radar.setup();
+  // Confirm the boot configuration so the measurement is not interleaved with retries
+  radar.play(ByteStream().pause(20).line(Radar::default_config()));
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < rounds; round++) {
+    radar.component.inject(block.data(), block.size());
+    esphome::host::advance_us(LOOP_INTERVAL_US);
+    radar.loop();
+    radar.speed.clear_history();
+    radar.velocity.clear_history();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  return ns / (frames_per_block * rounds);
+}
+
+static int replay_capture(const char *path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::printf("Cannot open %s\n", path);
+    return 1;
+  }
+  std::vector<uint8_t> capture((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  Radar radar;
+  radar.setup();
+  ByteStream stream;
+  stream.frame(capture.data(), capture.size());
+  radar.play(stream, 2000);
+
+  size_t frames = 0;
+  for (uint8_t c : capture)
+    frames += c == '\n';
+  std::printf("%zu bytes, %zu lines, %zu speed updates, %g vehicles\n", capture.size(), frames,
+              radar.speed.history().size(), radar.vehicle_count.has_state() ? radar.vehicle_count.state : 0.0f);
+  std::printf("parse failures %g, unknown frames %g, buffer overruns %g\n", radar.parse_failures.state,
+              radar.unknown_frames.state, radar.buffer_overruns.state);
+  if (frames > 0)
+    std::printf("%.1f ns/frame\n", measure(capture, frames, 200));
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+    return replay_capture(argv[1]);
+
+  check_scenario();
+  check_deadband();
+
+  ByteStream block;
+  for (int i = 0; i < 64; i++)
+    block.speed((i * 37) % 1200 - 600);
+  std::printf("%.1f ns/frame\n", measure(block.bytes(), 64, 20000));
+
+  return test_failures();
+}
@@ -0,0 +1,69 @@
+#!/bin/bash
+# Code size and static-initialisation cost of the ld2415h component at one or
+# more git revisions, built for the host against the stand-ins in stubs/.
+#
+#   tests/host/size_report.sh HEAD~1 HEAD
+#
+# Figures are for the host compiler at -Os, so they compare revisions rather
+# than predict the size of a device build: text/data/bss are summed over the
+# component's objects, "constructors" counts objects that need a static
+# initialiser, and "static-init allocations" counts operator new calls made
+# before main().
+set -euo pipefail
+
+HOST_DIR=$(cd "$(dirname "$0")" && pwd)
+REPO_DIR=$(cd "$HOST_DIR/../.." && pwd)
+CXX=${CXX:-g++}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+cat >"$WORK/count_new.cpp" <<'EOF'
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+static size_t allocations = 0, allocated = 0;
+static bool in_main = false;
+void *operator new(size_t n) {
+  if (!in_main) {
+    allocations++;
+    allocated += n;
+  }
+  void *p = std::malloc(n ? n : 1);
+  if (p == nullptr)
+    throw std::bad_alloc();
+  return p;
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+int main() {
+  in_main = true;
+  std::printf("static-init allocations: %zu (%zu bytes)\n", allocations, allocated);
+}
+EOF
+"$CXX" -std=gnu++17 -Os -I"$HOST_DIR/stubs" -c "$HOST_DIR/stubs/esphome.cpp" -o "$WORK/esphome.o"
+
+for rev in "$@"; do
+  src="$WORK/$rev/src"
+  mkdir -p "$src/esphome/components"
+  git -C "$REPO_DIR" archive "$rev" components/ld2415h | tar -x -C "$src"
+  mv "$src/components/ld2415h" "$src/esphome/components/ld2415h"
+
+  objs=()
+  constructors=0
+  while read -r file; do
+    obj="$WORK/$rev/$(echo "$file" | tr / _).o"
+    "$CXX" -std=gnu++17 -Os -ffunction-sections -fdata-sections -I"$HOST_DIR/stubs" -I"$src" \
+      -DUSE_SENSOR -DUSE_NUMBER -DUSE_SELECT -c "$src/$file" -o "$obj"
+    objs+=("$obj")
+    if readelf -S -W "$obj" | grep init_array >/dev/null; then
+      constructors=$((constructors + 1))
+    fi
+  done < <(cd "$src" && find esphome/components/ld2415h -name '*.cpp' | sort)
+
+  "$CXX" "$WORK/count_new.cpp" "${objs[@]}" "$WORK/esphome.o" -o "$WORK/$rev/count"
+
+  echo "== $rev ($(git -C "$REPO_DIR" rev-parse --short "$rev"))"
+  size -t "${objs[@]}" | tail -1 | awk '{print "text " $1 ", data " $2 ", bss " $3}'
+  echo "constructors: $constructors of ${#objs[@]} objects"
+  "$WORK/$rev/count"
+done
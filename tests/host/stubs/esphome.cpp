@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/uart/uart.h"
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+#include "host.h"
+
+namespace esphome {
+
+namespace setup_priority {
+const float BUS = 1000.0f;
+const float IO = 900.0f;
+const float HARDWARE = 800.0f;
+const float DATA = 600.0f;
+const float PROCESSOR = 400.0f;
+const float AFTER_WIFI = 200.0f;
+const float LATE = -100.0f;
+}  // namespace setup_priority
+
+// Clock
+
+static uint64_t host_time_us = 0;
+
+uint32_t millis() { return static_cast<uint32_t>(host_time_us / 1000); }
+uint32_t micros() { return static_cast<uint32_t>(host_time_us); }
+void delay(uint32_t ms) { host_time_us += static_cast<uint64_t>(ms) * 1000; }
+void delayMicroseconds(uint32_t us) { host_time_us += us; }
+
+// The cycle counter runs on wall time at a nominal 1 GHz, so profiled paths
+// report real host nanoseconds
+static const auto host_epoch = std::chrono::steady_clock::now();
+
+uint32_t arch_get_cpu_cycle_count() {
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - host_epoch).count());
+}
+uint32_t arch_get_cpu_freq_hz() { return 1000000000UL; }
+
+// Scheduler
+
+struct ScheduledItem {
+  Component *component;
+  std::string name;
+  uint32_t interval;
+  uint64_t next_us;
+  bool repeat;
+  std::function<void()> f;
+};
+
+static std::vector<ScheduledItem> &scheduled_items() {
+  static std::vector<ScheduledItem> items;
+  return items;
+}
+
+static bool cancel_item(Component *component, const std::string &name, bool repeat) {
+  auto &items = scheduled_items();
+  for (auto it = items.begin(); it != items.end(); ++it) {
+    if (it->component == component && it->name == name && it->repeat == repeat && !name.empty()) {
+      items.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+Component::~Component() {
+  auto &items = scheduled_items();
+  for (auto it = items.begin(); it != items.end();) {
+    it = it->component == this ? items.erase(it) : it + 1;
+  }
+}
+
+void Component::set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {
+  cancel_item(this, name, true);
+  scheduled_items().push_back({this, name, interval, host_time_us + interval * 1000ULL, true, std::move(f)});
+}
+
+bool Component::cancel_interval(const std::string &name) { return cancel_item(this, name, true); }
+
+void Component::set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {
+  cancel_item(this, name, false);
+  scheduled_items().push_back({this, name, timeout, host_time_us + timeout * 1000ULL, false, std::move(f)});
+}
+
+bool Component::cancel_timeout(const std::string &name) { return cancel_item(this, name, false); }
+
+void PollingComponent::call_setup() {
+  this->setup();
+  if (this->update_interval_ > 0)
+    this->set_interval("update", this->update_interval_, [this]() { this->update(); });
+}
+
+// Logging
+
+static int host_log_level() {
+  static int level = [] {
+    const char *env = std::getenv("LD2415H_HOST_LOG");
+    return env != nullptr ? std::atoi(env) : ESPHOME_LOG_LEVEL_WARN;
+  }();
+  return level;
+}
+
+static int log_level_override = -1;
+
+static void default_log_sink(int level, const char *tag, const char *message) {
+  static const char LETTERS[] = "?EWICDVV";
+  std::fprintf(stderr, "[%c][%s] %s\n", LETTERS[level & 7], tag, message);
+}
+
+static host::LogSink &log_sink() {
+  static host::LogSink sink = default_log_sink;
+  return sink;
+}
+
+void esp_log_printf_(int level, const char *tag, int line, const char *format, ...) {
+  int threshold = log_level_override >= 0 ? log_level_override : host_log_level();
+  if (level > threshold)
+    return;
+
+  char buffer[512];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  log_sink()(level, tag, buffer);
+}
+
+// Helpers
+
+uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+  for (char c : str) {
+    hash *= 16777619UL;
+    hash ^= c;
+  }
+  return hash;
+}
+
+std::string format_hex(const uint8_t *data, size_t length) {
+  std::string ret;
+  char buffer[3];
+  for (size_t i = 0; i < length; i++) {
+    snprintf(buffer, sizeof(buffer), "%02x", data[i]);
+    ret += buffer;
+  }
+  return ret;
+}
+
+std::string format_hex_pretty(const uint8_t *data, size_t length) {
+  std::string ret;
+  char buffer[4];
+  for (size_t i = 0; i < length; i++) {
+    snprintf(buffer, sizeof(buffer), i == 0 ? "%02X" : ".%02X", data[i]);
+    ret += buffer;
+  }
+  if (length > 4)
+    ret += " (" + std::to_string(length) + ")";
+  return ret;
+}
+
+// Preferences
+
+static std::map<uint32_t, std::vector<uint8_t>> &preference_store() {
+  static std::map<uint32_t, std::vector<uint8_t>> store;
+  return store;
+}
+
+static uint32_t preference_write_count = 0;
+
+class HostPreferenceBackend : public ESPPreferenceBackend {
+ public:
+  HostPreferenceBackend(uint32_t key, size_t length) : key_(key), length_(length) {}
+
+  bool save(const uint8_t *data, size_t len) override {
+    if (len != this->length_)
+      return false;
+    preference_store()[this->key_].assign(data, data + len);
+    preference_write_count++;
+    return true;
+  }
+
+  bool load(uint8_t *data, size_t len) override {
+    auto it = preference_store().find(this->key_);
+    if (it == preference_store().end() || it->second.size() != len)
+      return false;
+    std::memcpy(data, it->second.data(), len);
+    return true;
+  }
+
+ protected:
+  uint32_t key_;
+  size_t length_;
+};
+
+class HostPreferences : public ESPPreferences {
+ public:
+  ESPPreferenceObject make_preference(size_t length, uint32_t type, bool in_flash) override {
+    // Backends live for the whole run, like the device preference slots
+    this->backends_.emplace_back(new HostPreferenceBackend(type, length));
+    return ESPPreferenceObject(this->backends_.back().get());
+  }
+  ESPPreferenceObject make_preference(size_t length, uint32_t type) override {
+    return this->make_preference(length, type, false);
+  }
+  bool sync() override { return true; }
+
+ protected:
+  std::vector<std::unique_ptr<HostPreferenceBackend>> backends_;
+};
+
+static HostPreferences host_preferences;
+ESPPreferences *global_preferences = &host_preferences;
+
+// Entities
+
+namespace sensor {
+
+void Sensor::publish_state(float state) {
+  this->state = state;
+  this->has_state_ = true;
+  this->history_.push_back(state);
+}
+
+}  // namespace sensor
+
+namespace uart {
+
+bool UARTDevice::read_byte(uint8_t *data) {
+  if (this->rx_.empty())
+    return false;
+  *data = this->rx_.front();
+  this->rx_.pop_front();
+  return true;
+}
+
+bool UARTDevice::peek_byte(uint8_t *data) {
+  if (this->rx_.empty())
+    return false;
+  *data = this->rx_.front();
+  return true;
+}
+
+bool UARTDevice::read_array(uint8_t *data, size_t len) {
+  if (this->rx_.size() < len)
+    return false;
+  std::copy(this->rx_.begin(), this->rx_.begin() + len, data);
+  this->rx_.erase(this->rx_.begin(), this->rx_.begin() + len);
+  return true;
+}
+
+void UARTDevice::write_array(const uint8_t *data, size_t len) { this->tx_.insert(this->tx_.end(), data, data + len); }
+
+void UARTDevice::inject(const char *text) { this->inject(reinterpret_cast<const uint8_t *>(text), std::strlen(text)); }
+
+}  // namespace uart
+
+// Host controls
+
+namespace host {
+
+void set_time_us(uint64_t us) { host_time_us = us; }
+void advance_us(uint64_t us) { host_time_us += us; }
+uint64_t now_us() { return host_time_us; }
+
+void run_scheduler() {
+  // Callbacks may add or cancel items, so pick one due item at a time
+  while (true) {
+    auto &items = scheduled_items();
+    auto due = items.end();
+    for (auto it = items.begin(); it != items.end(); ++it) {
+      if (it->next_us <= host_time_us && (due == items.end() || it->next_us < due->next_us))
+        due = it;
+    }
+    if (due == items.end())
+      return;
+
+    // Like the device scheduler, a late interval is not caught up
+    std::function<void()> f = due->f;
+    if (due->repeat) {
+      due->next_us = host_time_us + std::max<uint64_t>(due->interval * 1000ULL, 1);
+    } else {
+      items.erase(due);
+    }
+    f();
+  }
+}
+
+void set_log_level(int level) { log_level_override = level; }
+void set_log_sink(LogSink &&sink) { log_sink() = std::move(sink); }
+void reset_log_sink() { log_sink() = default_log_sink; }
+
+void clear_preferences() { preference_store().clear(); }
+
+size_t preference_bytes() {
+  size_t total = 0;
+  for (auto &entry : preference_store())
+    total += entry.second.size();
+  return total;
+}
+
+uint32_t preference_writes() { return preference_write_count; }
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace number {
+
+class Number;
+
+class NumberCall {
+ public:
+  explicit NumberCall(Number *parent) : parent_(parent) {}
+  NumberCall &set_value(float value) {
+    this->value_ = value;
+    return *this;
+  }
+  void perform();
+
+ protected:
+  Number *parent_;
+  float value_{NAN};
+};
+
+class Number {
+ public:
+  void publish_state(float state) {
+    this->state = state;
+    this->has_state_ = true;
+  }
+  NumberCall make_call() { return NumberCall(this); }
+  bool has_state() const { return this->has_state_; }
+
+  float state{NAN};
+
+ protected:
+  friend class NumberCall;
+  virtual void control(float value) = 0;
+
+  bool has_state_{false};
+};
+
+inline void NumberCall::perform() { this->parent_->control(this->value_); }
+
+}  // namespace number
+}  // namespace esphome
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace select {
+
+class Select;
+
+class SelectCall {
+ public:
+  explicit SelectCall(Select *parent) : parent_(parent) {}
+  SelectCall &set_option(const std::string &option) {
+    this->option_ = option;
+    return *this;
+  }
+  void perform();
+
+ protected:
+  Select *parent_;
+  std::string option_;
+};
+
+class Select {
+ public:
+  void publish_state(const std::string &state) {
+    this->state = state;
+    this->has_state_ = true;
+  }
+  SelectCall make_call() { return SelectCall(this); }
+  bool has_state() const { return this->has_state_; }
+
+  std::string state;
+
+ protected:
+  friend class SelectCall;
+  virtual void control(const std::string &value) = 0;
+
+  bool has_state_{false};
+};
+
+inline void SelectCall::perform() { this->parent_->control(this->option_); }
+
+}  // namespace select
+}  // namespace esphome
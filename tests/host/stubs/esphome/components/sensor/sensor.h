@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace sensor {
+
+// Keeps every published state so tests can check the sequence
+class Sensor {
+ public:
+  Sensor() = default;
+  explicit Sensor(const std::string &name) : name_(name) {}
+
+  void publish_state(float state);
+  float get_state() const { return this->state; }
+  bool has_state() const { return this->has_state_; }
+  const std::string &get_name() const { return this->name_; }
+
+  const std::vector<float> &history() const { return this->history_; }
+  void clear_history() { this->history_.clear(); }
+
+  float state{NAN};
+
+ protected:
+  std::string name_;
+  bool has_state_{false};
+  std::vector<float> history_;
+};
+
+}  // namespace sensor
+}  // namespace esphome
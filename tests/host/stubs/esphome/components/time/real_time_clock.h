@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+struct ESPTime {
+  time_t timestamp{0};
+  bool is_valid() const { return this->timestamp > 1500000000; }
+};
+
+namespace time {
+
+// Reports a fixed epoch offset from the host clock, or invalid until set
+class RealTimeClock : public Component {
+ public:
+  ESPTime now() {
+    ESPTime time;
+    if (this->epoch_at_boot_ != 0)
+      time.timestamp = this->epoch_at_boot_ + millis() / 1000;
+    return time;
+  }
+  void set_epoch_at_boot(time_t epoch) { this->epoch_at_boot_ = epoch; }
+
+ protected:
+  time_t epoch_at_boot_{0};
+};
+
+}  // namespace time
+}  // namespace esphome
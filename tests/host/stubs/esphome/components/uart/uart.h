@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace uart {
+
+enum UARTParityOptions { UART_CONFIG_PARITY_NONE, UART_CONFIG_PARITY_EVEN, UART_CONFIG_PARITY_ODD };
+
+// Bytes queued with inject() are returned by the read calls; bytes written by
+// the component are kept for inspection
+class UARTDevice {
+ public:
+  UARTDevice() = default;
+
+  int available() { return static_cast<int>(this->rx_.size()); }
+  bool read_byte(uint8_t *data);
+  bool peek_byte(uint8_t *data);
+  bool read_array(uint8_t *data, size_t len);
+  uint8_t read() {
+    uint8_t data = 0;
+    this->read_byte(&data);
+    return data;
+  }
+  void write_byte(uint8_t data) { this->write_array(&data, 1); }
+  void write_array(const uint8_t *data, size_t len);
+  void write_array(const std::vector<uint8_t> &data) { this->write_array(data.data(), data.size()); }
+  void flush() {}
+
+  // Host side of the wire
+  void inject(const uint8_t *data, size_t len) { this->rx_.insert(this->rx_.end(), data, data + len); }
+  void inject(const char *text);
+  std::vector<uint8_t> &written() { return this->tx_; }
+
+ protected:
+  std::deque<uint8_t> rx_;
+  std::vector<uint8_t> tx_;
+};
+
+}  // namespace uart
+}  // namespace esphome
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <tuple>
+#include <utility>
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+
+template<typename... Ts> class Action {
+ public:
+  virtual ~Action() = default;
+  void play_complex(Ts... x) { this->play(x...); }
+
+ protected:
+  virtual void play(Ts... x) = 0;
+};
+
+template<typename... Ts> class Trigger {
+ public:
+  void trigger(Ts... x) {
+    for (auto &action : this->actions_)
+      action(x...);
+  }
+  void add_action(std::function<void(Ts...)> &&action) { this->actions_.push_back(std::move(action)); }
+
+ protected:
+  std::vector<std::function<void(Ts...)>> actions_;
+};
+
+template<typename T, typename... X> class TemplatableValue {
+ public:
+  TemplatableValue() = default;
+  TemplatableValue(T value) : value_(value), has_value_(true) {}
+  bool has_value() const { return this->has_value_; }
+  T value(X... x) { return this->value_; }
+
+ protected:
+  T value_{};
+  bool has_value_{false};
+};
+
+}  // namespace esphome
+
+#define TEMPLATABLE_VALUE_(type, name) \
+ protected: \
+  TemplatableValue<type, Ts...> name##_{}; \
+\
+ public: \
+  template<typename V> void set_##name(V name) { this->name##_ = name; }
+
+#define TEMPLATABLE_VALUE(type, name) TEMPLATABLE_VALUE_(type, name)
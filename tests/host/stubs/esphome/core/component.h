@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "esphome/core/defines.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+
+namespace setup_priority {
+extern const float BUS;
+extern const float IO;
+extern const float HARDWARE;
+extern const float DATA;
+extern const float PROCESSOR;
+extern const float AFTER_WIFI;
+extern const float LATE;
+}  // namespace setup_priority
+
+// Intervals and timeouts run from host::run_scheduler() against the host clock
+class Component {
+ public:
+  virtual ~Component();
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual void on_shutdown() {}
+  virtual float get_setup_priority() const { return setup_priority::DATA; }
+
+  void mark_failed() { this->failed_ = true; }
+  bool is_failed() const { return this->failed_; }
+  void status_set_warning() {}
+  void status_clear_warning() {}
+
+ protected:
+  void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f);
+  void set_interval(uint32_t interval, std::function<void()> &&f) { this->set_interval("", interval, std::move(f)); }
+  bool cancel_interval(const std::string &name);
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);
+  void set_timeout(uint32_t timeout, std::function<void()> &&f) { this->set_timeout("", timeout, std::move(f)); }
+  bool cancel_timeout(const std::string &name);
+
+  bool failed_{false};
+};
+
+class PollingComponent : public Component {
+ public:
+  PollingComponent() : PollingComponent(0) {}
+  explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+  virtual void update() = 0;
+  void call_setup();
+  uint32_t get_update_interval() const { return this->update_interval_; }
+  void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+
+ protected:
+  uint32_t update_interval_;
+};
+
+}  // namespace esphome
+
+#define LOG_UPDATE_INTERVAL(this) \
+  ESP_LOGCONFIG(TAG, "  Update Interval: %.1fs", static_cast<float>((this)->get_update_interval()) / 1000.0f)
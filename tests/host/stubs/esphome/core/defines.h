@@ -0,0 +1,3 @@
+#pragma once
+
+// Host builds take their feature defines from CMake
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace esphome {
+
+class GPIOPin {
+ public:
+  virtual void setup() = 0;
+  virtual bool digital_read() = 0;
+  virtual void digital_write(bool value) = 0;
+  virtual std::string dump_summary() const = 0;
+};
+
+// Records the last written level and the number of writes
+class InternalGPIOPin : public GPIOPin {
+ public:
+  void setup() override {}
+  bool digital_read() override { return this->state_; }
+  void digital_write(bool value) override {
+    this->state_ = value;
+    this->writes_++;
+  }
+  std::string dump_summary() const override { return "host pin"; }
+  uint32_t writes() const { return this->writes_; }
+
+ protected:
+  bool state_{false};
+  uint32_t writes_{0};
+};
+
+}  // namespace esphome
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include "esphome/core/gpio.h"
+
+namespace esphome {
+
+// Driven by the host clock in host.h, not by wall time
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+uint32_t arch_get_cpu_cycle_count();
+uint32_t arch_get_cpu_freq_hz();
+
+}  // namespace esphome
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace esphome {
+
+using std::to_string;
+
+template<typename T> class Parented {
+ public:
+  Parented() = default;
+  Parented(T *parent) : parent_(parent) {}
+  T *get_parent() const { return this->parent_; }
+  void set_parent(T *parent) { this->parent_ = parent; }
+
+ protected:
+  T *parent_{nullptr};
+};
+
+template<typename... X> class CallbackManager;
+
+template<typename... Ts> class CallbackManager<void(Ts...)> {
+ public:
+  void add(std::function<void(Ts...)> &&callback) { this->callbacks_.push_back(std::move(callback)); }
+  void call(Ts... args) {
+    for (auto &cb : this->callbacks_)
+      cb(args...);
+  }
+  size_t size() const { return this->callbacks_.size(); }
+
+ protected:
+  std::vector<std::function<void(Ts...)>> callbacks_;
+};
+
+// Same hash as the device, so preference keys match
+uint32_t fnv1_hash(const std::string &str);
+std::string format_hex(const uint8_t *data, size_t length);
+std::string format_hex_pretty(const uint8_t *data, size_t length);
+
+}  // namespace esphome
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstdint>
+
+#define ESPHOME_LOG_LEVEL_NONE 0
+#define ESPHOME_LOG_LEVEL_ERROR 1
+#define ESPHOME_LOG_LEVEL_WARN 2
+#define ESPHOME_LOG_LEVEL_INFO 3
+#define ESPHOME_LOG_LEVEL_CONFIG 4
+#define ESPHOME_LOG_LEVEL_DEBUG 5
+#define ESPHOME_LOG_LEVEL_VERBOSE 6
+#define ESPHOME_LOG_LEVEL_VERY_VERBOSE 7
+
+#ifndef ESPHOME_LOG_LEVEL
+#define ESPHOME_LOG_LEVEL ESPHOME_LOG_LEVEL_DEBUG
+#endif
+
+namespace esphome {
+
+// Formats the message like the device logger, then hands it to the host sink
+void esp_log_printf_(int level, const char *tag, int line, const char *format, ...)
+    __attribute__((format(printf, 4, 5)));
+
+}  // namespace esphome
+
+#define ESP_LOG_AT_(level, tag, ...) ::esphome::esp_log_printf_(level, tag, __LINE__, __VA_ARGS__)
+
+// Levels above ESPHOME_LOG_LEVEL compile to nothing, as on the device
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_ERROR
+#define ESP_LOGE(tag, ...) ESP_LOG_AT_(ESPHOME_LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+#else
+#define ESP_LOGE(tag, ...)
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_WARN
+#define ESP_LOGW(tag, ...) ESP_LOG_AT_(ESPHOME_LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#else
+#define ESP_LOGW(tag, ...)
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_INFO
+#define ESP_LOGI(tag, ...) ESP_LOG_AT_(ESPHOME_LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#else
+#define ESP_LOGI(tag, ...)
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_CONFIG
+#define ESP_LOGCONFIG(tag, ...) ESP_LOG_AT_(ESPHOME_LOG_LEVEL_CONFIG, tag, __VA_ARGS__)
+#else
+#define ESP_LOGCONFIG(tag, ...)
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_DEBUG
+#define ESP_LOGD(tag, ...) ESP_LOG_AT_(ESPHOME_LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#else
+#define ESP_LOGD(tag, ...)
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE
+#define ESP_LOGV(tag, ...) ESP_LOG_AT_(ESPHOME_LOG_LEVEL_VERBOSE, tag, __VA_ARGS__)
+#else
+#define ESP_LOGV(tag, ...)
+#endif
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERY_VERBOSE
+#define ESP_LOGVV(tag, ...) ESP_LOG_AT_(ESPHOME_LOG_LEVEL_VERY_VERBOSE, tag, __VA_ARGS__)
+#else
+#define ESP_LOGVV(tag, ...)
+#endif
+
+#define LOG_SENSOR(prefix, type, obj) \
+  if ((obj) != nullptr) { \
+    ESP_LOGCONFIG(TAG, "%s%s", prefix, type); \
+  }
+#define LOG_NUMBER(prefix, type, obj) LOG_SENSOR(prefix, type, obj)
+#define LOG_SELECT(prefix, type, obj) LOG_SENSOR(prefix, type, obj)
+#define LOG_PIN(prefix, pin) \
+  if ((pin) != nullptr) { \
+    ESP_LOGCONFIG(TAG, "%s%s", prefix, (pin)->dump_summary().c_str()); \
+  }
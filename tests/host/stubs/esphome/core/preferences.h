@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace esphome {
+
+// Preferences held in a map keyed by the preference key, which survives a
+// component being destroyed and recreated to simulate a reboot
+class ESPPreferenceBackend {
+ public:
+  virtual bool save(const uint8_t *data, size_t len) = 0;
+  virtual bool load(uint8_t *data, size_t len) = 0;
+};
+
+class ESPPreferenceObject {
+ public:
+  ESPPreferenceObject() = default;
+  ESPPreferenceObject(ESPPreferenceBackend *backend) : backend_(backend) {}
+
+  template<typename T> bool save(const T *src) {
+    if (this->backend_ == nullptr)
+      return false;
+    return this->backend_->save(reinterpret_cast<const uint8_t *>(src), sizeof(T));
+  }
+
+  template<typename T> bool load(T *dest) {
+    if (this->backend_ == nullptr)
+      return false;
+    return this->backend_->load(reinterpret_cast<uint8_t *>(dest), sizeof(T));
+  }
+
+ protected:
+  ESPPreferenceBackend *backend_{nullptr};
+};
+
+class ESPPreferences {
+ public:
+  virtual ESPPreferenceObject make_preference(size_t length, uint32_t type, bool in_flash) = 0;
+  virtual ESPPreferenceObject make_preference(size_t length, uint32_t type) = 0;
+  virtual bool sync() = 0;
+
+  template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool in_flash) {
+    return this->make_preference(sizeof(T), type, in_flash);
+  }
+  template<typename T> ESPPreferenceObject make_preference(uint32_t type) {
+    return this->make_preference(sizeof(T), type);
+  }
+};
+
+extern ESPPreferences *global_preferences;
+
+}  // namespace esphome
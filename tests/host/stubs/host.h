@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Controls for the host stand-ins of the ESPHome core. Nothing here exists on
+// the device; it is only used by the host tests and benchmarks.
+namespace esphome {
+namespace host {
+
+// millis() and micros() follow this clock, which only moves when told to
+void set_time_us(uint64_t us);
+void advance_us(uint64_t us);
+inline void advance_ms(uint32_t ms) { advance_us(static_cast<uint64_t>(ms) * 1000); }
+uint64_t now_us();
+
+// Run the intervals and timeouts that are due at the current host time
+void run_scheduler();
+
+// Messages at or below the level go to the sink, which prints to stderr by
+// default. LD2415H_HOST_LOG sets the initial level (default: warnings).
+using LogSink = std::function<void(int level, const char *tag, const char *message)>;
+void set_log_level(int level);
+void set_log_sink(LogSink &&sink);
+void reset_log_sink();
+
+// The preference store outlives components, so a component created again
+// with the same keys sees what the previous one saved, as after a reboot
+void clear_preferences();
+size_t preference_bytes();
+uint32_t preference_writes();
+
+}  // namespace host
+}  // namespace esphome
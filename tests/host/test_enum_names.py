@@ -0,0 +1,54 @@
+"""Checks that the select option lists in the component's Python module match
+the EnumTable names in ld2415h.h.
+
+The select entities are created with the Python lists, while the C++ setters
+look names up in the EnumTables, so a name that differs would be rejected at
+runtime. Both files are parsed as text, so ESPHome does not need to be installed.
+"""
+
+import ast
+from pathlib import Path
+import re
+
+import pytest
+
+COMPONENT = Path(__file__).resolve().parents[2] / "components" / "ld2415h"
+
+# Python option list -> C++ EnumTable
+TABLES = {
+    "SAMPLE_RATE_OPTIONS": "SAMPLE_RATE_NAMES",
+    "TRACKING_MODE_OPTIONS": "TRACKING_MODE_NAMES",
+}
+
+
+def python_lists():
+    tree = ast.parse((COMPONENT / "__init__.py").read_text())
+    lists = {}
+    for node in tree.body:
+        if isinstance(node, ast.Assign) and len(node.targets) == 1:
+            name = getattr(node.targets[0], "id", None)
+            if name in TABLES:
+                lists[name] = ast.literal_eval(node.value)
+    return lists
+
+
+def cpp_tables():
+    header = (COMPONENT / "ld2415h.h").read_text()
+    tables = {}
+    for match in re.finditer(
+        r"EnumTable<(\d+)>\s+(\w+)\s*\{\s*\w+\s*,\s*\{([^}]*)\}\s*\}", header
+    ):
+        size, name, body = match.groups()
+        names = re.findall(r'"((?:[^"\\]|\\.)*)"', body)
+        assert len(names) == int(size), name
+        tables[name] = names
+    return tables
+
+
+@pytest.mark.parametrize("option_list,table", TABLES.items())
+def test_names_match(option_list, table):
+    lists = python_lists()
+    tables = cpp_tables()
+    assert option_list in lists, f"{option_list} not found in __init__.py"
+    assert table in tables, f"{table} not found in ld2415h.h"
+    assert lists[option_list] == tables[table]
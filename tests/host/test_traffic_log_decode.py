@@ -0,0 +1,152 @@
+"""Tests for tools/ld2415h_log_decode.py.
+
+Run with pytest. The round trip through the component needs the
+traffic_log_dump host binary, passed in LD2415H_TRAFFIC_LOG_DUMP by CTest.
+"""
+
+import importlib.util
+import os
+from pathlib import Path
+import subprocess
+
+import pytest
+
+DECODER = Path(__file__).resolve().parents[2] / "tools" / "ld2415h_log_decode.py"
+spec = importlib.util.spec_from_file_location("ld2415h_log_decode", DECODER)
+decoder = importlib.util.module_from_spec(spec)
+spec.loader.exec_module(decoder)
+
+
+def encode_varint(value):
+    """Unsigned LEB128, as TrafficLog::encode_varint_()."""
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def encode_record(delta, direction, max_speed, mean_speed, duration):
+    return (
+        encode_varint((delta << 2) | direction)
+        + encode_varint(max_speed)
+        + encode_varint(max_speed - mean_speed)
+        + encode_varint(duration)
+    )
+
+
+def make_page(data, base_time=0, base_uptime=0):
+    return {
+        "base_time": base_time,
+        "base_uptime": base_uptime,
+        "used": len(data),
+        "data": bytearray(data),
+    }
+
+
+@pytest.mark.parametrize(
+    "value", [0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0x1FFFFF, 0x200000, 0xFFFFFFF, 0xFFFFFFFF]
+)
+def test_varint_round_trip(value):
+    data = b"\x55" + encode_varint(value) + b"\x55"
+    decoded, offset = decoder.read_varint(data, 1)
+    assert decoded == value
+    assert offset == len(data) - 1
+
+
+def test_varint_lengths():
+    assert len(encode_varint(0x7F)) == 1
+    assert len(encode_varint(0x80)) == 2
+    assert len(encode_varint(0xFFFFFFFF)) == 5
+
+
+def test_truncated_varint():
+    with pytest.raises(ValueError):
+        decoder.read_varint(b"\x80\x80", 0)
+
+
+def test_decode_page():
+    data = encode_record(0, 1, 523, 480, 12) + encode_record(35, 2, 1234, 1200, 0)
+    records = list(decoder.decode_page(7, make_page(data, 1700000000, 10000)))
+
+    assert records == [
+        {
+            "page": 7,
+            "time": "2023-11-14T22:13:20+00:00",
+            "uptime_ms": 10000,
+            "direction": "approaching",
+            "max_speed": 52.3,
+            "mean_speed": 48.0,
+            "duration_ms": 1200,
+        },
+        {
+            "page": 7,
+            "time": "2023-11-14T22:13:23+00:00",
+            "uptime_ms": 13500,
+            "direction": "retreating",
+            "max_speed": 123.4,
+            "mean_speed": 120.0,
+            "duration_ms": 0,
+        },
+    ]
+
+
+def test_decode_page_without_time():
+    records = list(decoder.decode_page(1, make_page(encode_record(0, 0, 10, 10, 1))))
+    assert records[0]["time"] == ""
+    assert records[0]["direction"] == "none"
+
+
+def test_truncated_page(capsys):
+    data = encode_record(0, 1, 523, 480, 12) + encode_record(35, 2, 1234, 1200, 0)[:-1]
+    records = list(decoder.decode_page(3, make_page(data)))
+
+    assert len(records) == 1
+    assert "page 3: truncated" in capsys.readouterr().err
+
+
+def test_read_pages():
+    lines = [
+        "[12:00:00][I][LD2415H.traffic_log:123]: page 2 0 5000 70\n",
+        "[12:00:00][I][LD2415H.traffic_log:127]: data 2 " + "00" * 64 + "\n",
+        "[12:00:00][I][LD2415H.traffic_log:127]: data 2 " + "01" * 6 + "\n",
+        "[12:00:00][I][LD2415H.traffic_log:127]: data 9 ff\n",
+    ]
+    pages = decoder.read_pages(lines)
+
+    assert list(pages) == [2]
+    assert pages[2]["base_uptime"] == 5000
+    assert pages[2]["used"] == 70
+    assert pages[2]["data"] == bytes(64) + b"\x01" * 6
+
+
+@pytest.mark.skipif(
+    "LD2415H_TRAFFIC_LOG_DUMP" not in os.environ,
+    reason="needs the traffic_log_dump host binary",
+)
+def test_component_round_trip():
+    output = subprocess.run(
+        [os.environ["LD2415H_TRAFFIC_LOG_DUMP"]],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout.splitlines()
+
+    events = [list(map(int, line.split()[1:])) for line in output if line.startswith("event ")]
+    pages = decoder.read_pages(output)
+    records = [
+        record
+        for sequence in sorted(pages)
+        for record in decoder.decode_page(sequence, pages[sequence])
+    ]
+
+    assert len(pages) > 1
+    assert len(records) == len(events)
+    for record, (start, direction, max_speed, mean_speed, duration) in zip(records, events):
+        assert record["direction"] == decoder.DIRECTIONS[direction]
+        assert record["max_speed"] == max_speed / 10
+        assert record["mean_speed"] == mean_speed / 10
+        assert record["duration_ms"] == duration // 100 * 100
+        # Times are stored in 100 ms steps; the rounding must not accumulate
+        assert 0 <= start - record["uptime_ms"] < 100
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+// Minimal checks for the host tests: failures are printed and counted, and
+// main() returns test_failures() so CTest sees the result.
+namespace ld2415h_test {
+
+inline int &failure_count() {
+  static int count = 0;
+  return count;
+}
+
+inline int test_failures() {
+  if (failure_count() == 0) {
+    std::printf("All checks passed\n");
+  } else {
+    std::printf("%d checks failed\n", failure_count());
+  }
+  return failure_count() == 0 ? 0 : 1;
+}
+
+}  // namespace ld2415h_test
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      ld2415h_test::failure_count()++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(actual, expected) \
+  do { \
+    auto actual_ = (actual); \
+    auto expected_ = (expected); \
+    if (!(actual_ == expected_)) { \
+      std::printf("%s:%d: CHECK_EQ(%s, %s) failed: %g != %g\n", __FILE__, __LINE__, #actual, #expected, \
+                  static_cast<double>(actual_), static_cast<double>(expected_)); \
+      ld2415h_test::failure_count()++; \
+    } \
+  } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+  do { \
+    double actual_ = (actual); \
+    double expected_ = (expected); \
+    if (!(std::fabs(actual_ - expected_) <= (tolerance))) { \
+      std::printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g != %g\n", __FILE__, __LINE__, #actual, #expected, actual_, \
+                  expected_); \
+      ld2415h_test::failure_count()++; \
+    } \
+  } while (0)
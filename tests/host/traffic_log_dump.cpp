@@ -0,0 +1,52 @@
+// Logs a fixed sequence of vehicle events through TrafficLog and prints the
+// ld2415h.traffic_log.dump output, for test_traffic_log_decode.py to decode
+// with tools/ld2415h_log_decode.py. Each event is also printed as
+//   event <start ms> <direction> <max speed> <mean speed> <duration ms>
+// so the decoded records can be compared with what was logged.
+
+#include <cstdio>
+#include "esphome/components/ld2415h/traffic_log.h"
+#include "esphome/core/log.h"
+#include "host.h"
+
+using namespace esphome;
+using namespace esphome::ld2415h;
+
+int main() {
+  esphome::host::clear_preferences();
+  esphome::host::set_time_us(1000000);
+  esphome::host::set_log_level(ESPHOME_LOG_LEVEL_INFO);
+  esphome::host::set_log_sink([](int level, const char *tag, const char *message) {
+    if (level == ESPHOME_LOG_LEVEL_INFO)
+      std::printf("[I][%s]: %s\n", tag, message);
+  });
+
+  TrafficLog log;
+  log.set_id("test");
+  log.set_pages(4);
+  log.set_flush_interval(0);
+  log.setup();
+
+  // Starts that are not multiples of 100 ms, so every delta is rounded, over
+  // enough events to fill more than one page, with one long gap
+  uint32_t start = 5000;
+  for (int i = 0; i < 100; i++) {
+    start += 1050 + (i % 7) * 13;
+    if (i == 60)
+      start += 3 * 3600 * 1000;
+
+    VehicleEvent event{};
+    event.direction = i % 3 == 2 ? Direction::DIRECTION_RETREATING : Direction::DIRECTION_APPROACHING;
+    event.max_speed = 50 + (i * 97) % 2500;
+    event.mean_speed = event.max_speed - (i * 7) % 40;
+    event.start = start;
+    event.duration = (i * 311) % 9000;
+    event.frame_count = 5;
+    log.on_vehicle_event(event);
+    std::printf("event %u %u %d %d %u\n", event.start, event.direction, event.max_speed, event.mean_speed,
+                event.duration);
+  }
+
+  log.dump();
+  return 0;
+}
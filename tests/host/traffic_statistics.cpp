@@ -0,0 +1,131 @@
+// Tests for the traffic statistics window: the P-square percentile and the
+// speed bins against a known distribution, the exact percentile of fewer than
+// five vehicles, and the reset at each window boundary.
+
+#include <cmath>
+#include "esphome/components/ld2415h/sensor/traffic_statistics.h"
+#include "host.h"
+#include "test_util.h"
+
+using namespace esphome;
+using namespace esphome::ld2415h;
+
+static const uint32_t WINDOW_MS = 60000;
+
+class StatisticsFixture {
+ public:
+  StatisticsFixture() {
+    this->statistics.set_window(WINDOW_MS);
+    this->statistics.set_percentile(85);
+    this->statistics.set_percentile_speed_sensor(&this->percentile);
+    this->statistics.set_mean_speed_sensor(&this->mean);
+    this->statistics.set_count_sensor(&this->count);
+    this->statistics.set_approaching_count_sensor(&this->approaching);
+    this->statistics.set_retreating_count_sensor(&this->retreating);
+    this->statistics.add_speed_bin(0, 30, &this->slow);
+    this->statistics.add_speed_bin(30, 60, &this->medium);
+    this->statistics.add_speed_bin(60, 200, &this->fast);
+    this->statistics.setup();
+  }
+
+  void vehicle(float max_speed, Direction direction) {
+    VehicleEvent event{};
+    event.max_speed = std::lround(max_speed * 10);
+    event.mean_speed = event.max_speed;
+    event.direction = direction;
+    event.start = millis();
+    event.duration = 1000;
+    event.frame_count = 10;
+    this->statistics.on_vehicle_event(event);
+  }
+
+  // Moves to the end of the current window so it is published
+  void close_window() {
+    esphome::host::advance_ms(WINDOW_MS);
+    esphome::host::run_scheduler();
+  }
+
+  TrafficStatistics statistics;
+  sensor::Sensor percentile{"percentile"};
+  sensor::Sensor mean{"mean"};
+  sensor::Sensor count{"count"};
+  sensor::Sensor approaching{"approaching"};
+  sensor::Sensor retreating{"retreating"};
+  sensor::Sensor slow{"slow"};
+  sensor::Sensor medium{"medium"};
+  sensor::Sensor fast{"fast"};
+};
+
+// 1 to 100 km/h once each, in a scrambled order
+static void test_known_distribution() {
+  StatisticsFixture fixture;
+  for (int i = 0; i < 100; i++) {
+    Direction direction = i % 4 == 0 ? Direction::DIRECTION_RETREATING : Direction::DIRECTION_APPROACHING;
+    fixture.vehicle((i * 37) % 100 + 1, direction);
+  }
+  fixture.close_window();
+
+  CHECK_NEAR(fixture.percentile.state, 85.0, 2.0);
+  CHECK_NEAR(fixture.mean.state, 50.5, 1e-3);
+  CHECK_EQ(fixture.count.state, 100.0f);
+  CHECK_EQ(fixture.approaching.state, 75.0f);
+  CHECK_EQ(fixture.retreating.state, 25.0f);
+  // Bins include their lower bound and exclude the upper one
+  CHECK_EQ(fixture.slow.state, 29.0f);
+  CHECK_EQ(fixture.medium.state, 30.0f);
+  CHECK_EQ(fixture.fast.state, 41.0f);
+}
+
+// Before the five markers are placed the percentile is exact
+static void test_few_vehicles() {
+  StatisticsFixture fixture;
+  fixture.close_window();
+  CHECK(std::isnan(fixture.percentile.state));
+  CHECK(std::isnan(fixture.mean.state));
+
+  fixture.vehicle(40, Direction::DIRECTION_APPROACHING);
+  fixture.vehicle(20, Direction::DIRECTION_APPROACHING);
+  fixture.vehicle(30, Direction::DIRECTION_APPROACHING);
+  fixture.close_window();
+  CHECK_NEAR(fixture.percentile.state, 40.0, 1e-4);
+  CHECK_NEAR(fixture.mean.state, 30.0, 1e-4);
+  CHECK_EQ(fixture.count.state, 3.0f);
+
+  fixture.vehicle(20, Direction::DIRECTION_APPROACHING);
+  fixture.vehicle(30, Direction::DIRECTION_APPROACHING);
+  fixture.vehicle(40, Direction::DIRECTION_APPROACHING);
+  fixture.vehicle(50, Direction::DIRECTION_APPROACHING);
+  fixture.close_window();
+  CHECK_NEAR(fixture.percentile.state, 50.0, 1e-4);
+}
+
+// Nothing carries over from one window to the next
+static void test_reset() {
+  StatisticsFixture fixture;
+  for (int i = 0; i < 20; i++)
+    fixture.vehicle(90, Direction::DIRECTION_RETREATING);
+  fixture.close_window();
+  CHECK_NEAR(fixture.percentile.state, 90.0, 1e-4);
+  CHECK_EQ(fixture.fast.state, 20.0f);
+
+  fixture.close_window();
+  CHECK(std::isnan(fixture.percentile.state));
+  CHECK(std::isnan(fixture.mean.state));
+  CHECK_EQ(fixture.count.state, 0.0f);
+  CHECK_EQ(fixture.retreating.state, 0.0f);
+  CHECK_EQ(fixture.fast.state, 0.0f);
+
+  fixture.vehicle(25, Direction::DIRECTION_APPROACHING);
+  fixture.close_window();
+  CHECK_NEAR(fixture.percentile.state, 25.0, 1e-4);
+  CHECK_EQ(fixture.count.state, 1.0f);
+  CHECK_EQ(fixture.slow.state, 1.0f);
+  CHECK_EQ(fixture.fast.state, 0.0f);
+}
+
+int main() {
+  test_known_distribution();
+  test_few_vehicles();
+  test_reset();
+  return ld2415h_test::test_failures();
+}
@@ -0,0 +1,64 @@
+// Tests for the vehicle count sensors when two vehicles are in the beam at
+// once and their frames interleave.
+
+#include "harness.h"
+#include "test_util.h"
+
+using namespace ld2415h_test;
+
+class CountFixture {
+ public:
+  explicit CountFixture(uint8_t max_tracks) {
+    esphome::host::clear_preferences();
+    this->radar.component.set_max_tracks(max_tracks);
+    this->radar.platform.set_approaching_vehicle_count_sensor(&this->approaching);
+    this->radar.platform.set_retreating_vehicle_count_sensor(&this->retreating);
+    this->radar.platform.set_overlapping_vehicle_count_sensor(&this->overlapping);
+    this->radar.setup();
+    this->radar.play(ByteStream().pause(20).line(Radar::default_config()));
+  }
+
+  Radar radar;
+  sensor::Sensor approaching{"approaching"};
+  sensor::Sensor retreating{"retreating"};
+  sensor::Sensor overlapping{"overlapping"};
+};
+
+// A vehicle approaching at 50 km/h while another retreats at 30 km/h, their
+// frames alternating, then a lone approaching vehicle
+static ByteStream passing() {
+  ByteStream stream;
+  for (int i = 0; i < 10; i++)
+    stream.speed(500 + i).speed(-300 - i);
+  stream.pause(2000);
+  for (int i = 0; i < 5; i++)
+    stream.speed(400);
+  return stream;
+}
+
+static void test_counts_per_direction() {
+  CountFixture fixture(2);
+  fixture.radar.play(passing(), 2000);
+
+  CHECK_EQ(fixture.radar.vehicle_count.state, 3);
+  CHECK_EQ(fixture.approaching.state, 2);
+  CHECK_EQ(fixture.retreating.state, 1);
+  CHECK_EQ(fixture.overlapping.state, 2);
+}
+
+static void test_single_track() {
+  // One track follows whatever the sensor reports, so the pair is one vehicle
+  // with the direction of its first frame
+  CountFixture fixture(1);
+  fixture.radar.play(passing(), 2000);
+
+  CHECK_EQ(fixture.radar.vehicle_count.state, 2);
+  CHECK_EQ(fixture.approaching.state, 2);
+  CHECK(!fixture.retreating.has_state());
+}
+
+int main() {
+  test_counts_per_direction();
+  test_single_track();
+  return ld2415h_test::test_failures();
+}
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""Decode an LD2415H traffic log dump into CSV.
+
+Capture the device log while running the ld2415h.traffic_log.dump action,
+for example with `esphome logs device.yaml > dump.txt`, then run:
+
+    python3 tools/ld2415h_log_decode.py dump.txt > traffic.csv
+
+Reads from stdin when no file is given. See traffic_log.h for the format.
+"""
+
+import argparse
+import csv
+from datetime import datetime, timezone
+import re
+import sys
+
+PAGE_RE = re.compile(r"\bpage (\d+) (\d+) (\d+) (\d+)\s*$")
+DATA_RE = re.compile(r"\bdata (\d+) ([0-9a-f]+)\s*$")
+
+DIRECTIONS = ["none", "approaching", "retreating"]
+
+
+def read_pages(lines):
+    pages = {}
+    for line in lines:
+        if match := PAGE_RE.search(line):
+            sequence, base_time, base_uptime, used = map(int, match.groups())
+            pages[sequence] = {
+                "base_time": base_time,
+                "base_uptime": base_uptime,
+                "used": used,
+                "data": bytearray(),
+            }
+        elif match := DATA_RE.search(line):
+            sequence = int(match.group(1))
+            if sequence in pages:
+                pages[sequence]["data"] += bytes.fromhex(match.group(2))
+    return pages
+
+
+def read_varint(data, offset):
+    value = 0
+    shift = 0
+    while True:
+        if offset >= len(data):
+            raise ValueError("truncated varint")
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, offset
+        shift += 7
+
+
+def decode_page(sequence, page):
+    data = page["data"]
+    if len(data) != page["used"]:
+        print(
+            f"page {sequence}: expected {page['used']} bytes, got {len(data)}",
+            file=sys.stderr,
+        )
+
+    start = page["base_uptime"]
+    offset = 0
+    while offset < len(data):
+        try:
+            head, offset = read_varint(data, offset)
+            max_speed, offset = read_varint(data, offset)
+            mean_delta, offset = read_varint(data, offset)
+            duration, offset = read_varint(data, offset)
+        except ValueError:
+            print(f"page {sequence}: truncated at {offset}", file=sys.stderr)
+            return
+
+        start += (head >> 2) * 100
+        time = ""
+        if page["base_time"]:
+            epoch = page["base_time"] + (start - page["base_uptime"]) // 1000
+            time = datetime.fromtimestamp(epoch, timezone.utc).isoformat()
+        yield {
+            "page": sequence,
+            "time": time,
+            "uptime_ms": start,
+            "direction": DIRECTIONS[head & 0x03]
+            if (head & 0x03) < len(DIRECTIONS)
+            else "unknown",
+            "max_speed": max_speed / 10,
+            "mean_speed": (max_speed - mean_delta) / 10,
+            "duration_ms": duration * 100,
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"), default=sys.stdin)
+    args = parser.parse_args()
+
+    pages = read_pages(args.log)
+    writer = csv.DictWriter(
+        sys.stdout,
+        [
+            "page",
+            "time",
+            "uptime_ms",
+            "direction",
+            "max_speed",
+            "mean_speed",
+            "duration_ms",
+        ],
+    )
+    writer.writeheader()
+    for sequence in sorted(pages):
+        writer.writerows(decode_page(sequence, pages[sequence]))
+
+
+if __name__ == "__main__":
+    main()